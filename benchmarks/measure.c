@@ -0,0 +1,199 @@
+//
+//  measure.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <time.h>
+#undef _POSIX_C_SOURCE
+
+#include "../src/enigma.h"
+#include "../src/measure.h"
+#include "../src/simd.h"
+
+#define BENCHMARK_MESSAGE_LENGTH 10000
+#define BENCHMARK_NUM_CANDIDATES 8
+#define BENCHMARK_NUM_WINDOWS 20000000
+
+/**
+ * Return a monotonic timestamp in seconds.
+ */
+static double benchmark_now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec * 1e-9;
+}
+
+/**
+ * Fill the n-gram map for the given n with pseudo-random log probabilities,
+ * such that lookups are spread over the whole map like with real models.
+ */
+static void benchmark_ngram_map_init(unsigned int n) {
+    unsigned int map_size = bomm_pow_map[n];
+    bomm_ngram_map_t* map = malloc(
+        sizeof(bomm_ngram_map_t) + map_size * sizeof(bomm_ngram_map_entry));
+    map->n = n;
+    map->fallback = -20;
+    for (unsigned int i = 0; i < map_size; i++) {
+        map->map[i] = -(float) (rand() % 2000) / 100;
+    }
+    bomm_ngram_map[n] = map;
+}
+
+/**
+ * Report the time per window (in ns) of the given run.
+ */
+static void benchmark_report(
+    const char* name,
+    unsigned int n,
+    double start,
+    unsigned long num_windows,
+    double checksum
+) {
+    printf(
+        "%d-gram %-28s %6.2f ns/window (checksum %.1f)\n",
+        n,
+        name,
+        (benchmark_now() - start) * 1e9 / (double) num_windows,
+        checksum
+    );
+}
+
+int main(void) {
+    srand(1941);
+
+    bomm_message_t* message = malloc(bomm_message_size_for_length(BENCHMARK_MESSAGE_LENGTH));
+    message->length = BENCHMARK_MESSAGE_LENGTH;
+    for (unsigned int i = 0; i < BENCHMARK_MESSAGE_LENGTH; i++) {
+        message->letters[i] = rand() % BOMM_ALPHABET_SIZE;
+    }
+
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(message->length));
+    scrambler->length = message->length;
+    bomm_enigma_generate_scrambler(scrambler, &key);
+
+    // Candidates differing in a single plug each, like hill climb swaps
+    bomm_plugboard_t candidates[BENCHMARK_NUM_CANDIDATES];
+    bomm_plugboard_t* plugboards[BENCHMARK_NUM_CANDIDATES];
+    for (unsigned int c = 0; c < BENCHMARK_NUM_CANDIDATES; c++) {
+        bomm_plugboard_init_identity(&candidates[c]);
+        candidates[c].map[c] = c + 10;
+        candidates[c].map[c + 10] = c;
+        plugboards[c] = &candidates[c];
+    }
+
+    unsigned int num_windows_per_message = message->length;
+    unsigned int num_runs = BENCHMARK_NUM_WINDOWS / num_windows_per_message;
+    unsigned int distances[] = { 0, 4, 8, 16, 32 };
+    double scores[BENCHMARK_NUM_CANDIDATES];
+
+    // Dense hexagram maps (1.2 GB) exceed any cache, unlike smaller n
+    for (unsigned int n = 4; n <= 6; n++) {
+        benchmark_ngram_map_init(n);
+        unsigned long num_windows =
+            (unsigned long) num_runs * BENCHMARK_NUM_CANDIDATES *
+            (message->length - n + 1);
+
+        // Serial kernel
+        double checksum = 0;
+        double start = benchmark_now();
+        for (unsigned int run = 0; run < num_runs; run++) {
+            for (unsigned int c = 0; c < BENCHMARK_NUM_CANDIDATES; c++) {
+                checksum += bomm_measure_scrambler_sinkov(
+                    n, scrambler, plugboards[c], message);
+            }
+        }
+        benchmark_report("serial", n, start, num_windows, checksum);
+
+        // Single candidate with prefetching
+        for (unsigned int d = 0; d < sizeof(distances) / sizeof(distances[0]); d++) {
+            checksum = 0;
+            start = benchmark_now();
+            for (unsigned int run = 0; run < num_runs; run++) {
+                for (unsigned int c = 0; c < BENCHMARK_NUM_CANDIDATES; c++) {
+                    bomm_measure_scrambler_sinkov_batch(
+                        n, scrambler, &plugboards[c], 1, message,
+                        distances[d], scores);
+                    checksum += scores[0];
+                }
+            }
+            char name[64];
+            snprintf(name, sizeof(name), "prefetch distance %d", distances[d]);
+            benchmark_report(name, n, start, num_windows, checksum);
+        }
+
+        // Interleaved candidates with prefetching
+        for (unsigned int d = 0; d < sizeof(distances) / sizeof(distances[0]); d++) {
+            checksum = 0;
+            start = benchmark_now();
+            for (unsigned int run = 0; run < num_runs; run++) {
+                bomm_measure_scrambler_sinkov_batch(
+                    n, scrambler, plugboards, BENCHMARK_NUM_CANDIDATES,
+                    message, distances[d], scores);
+                for (unsigned int c = 0; c < BENCHMARK_NUM_CANDIDATES; c++) {
+                    checksum += scores[c];
+                }
+            }
+            char name[64];
+            snprintf(
+                name, sizeof(name), "batch of %d, distance %d",
+                BENCHMARK_NUM_CANDIDATES, distances[d]);
+            benchmark_report(name, n, start, num_windows, checksum);
+        }
+    }
+    free(bomm_ngram_map[6]);
+    bomm_ngram_map[6] = NULL;
+
+    // Decrypt and score throughput per instruction set extension
+    benchmark_ngram_map_init(2);
+    benchmark_ngram_map_init(3);
+    bomm_measure_t measures[] = {
+        BOMM_MEASURE_SINKOV_BIGRAM,
+        BOMM_MEASURE_SINKOV_TRIGRAM,
+        BOMM_MEASURE_SINKOV_QUADGRAM,
+        BOMM_MEASURE_SINKOV_PENTAGRAM,
+        BOMM_MEASURE_IC,
+        BOMM_MEASURE_IC_BIGRAM,
+        BOMM_MEASURE_ENTROPY
+    };
+    unsigned int lengths[] = { 250, BENCHMARK_MESSAGE_LENGTH };
+    bomm_simd_t max_simd = bomm_simd_detect();
+    for (unsigned int l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        message->length = lengths[l];
+        unsigned int num_measure_runs = BENCHMARK_NUM_WINDOWS / lengths[l];
+        for (unsigned int m = 0; m < sizeof(measures) / sizeof(measures[0]); m++) {
+            for (bomm_simd_t simd = BOMM_SIMD_NONE; simd <= max_simd; simd++) {
+                bomm_measure_scrambler_function_t function =
+                    bomm_simd_measure_scrambler_function(measures[m], simd);
+                double checksum = 0;
+                double start = benchmark_now();
+                for (unsigned int run = 0; run < num_measure_runs; run++) {
+                    checksum += function(
+                        scrambler, plugboards[run % BENCHMARK_NUM_CANDIDATES], message);
+                }
+                printf(
+                    "%-16s %4d letters %-6s %6.2f ns/letter (checksum %.1f)\n",
+                    bomm_measure_to_string(measures[m]),
+                    lengths[l],
+                    bomm_simd_to_string(simd),
+                    (benchmark_now() - start) * 1e9 /
+                        ((double) num_measure_runs * lengths[l]),
+                    checksum
+                );
+            }
+        }
+    }
+    message->length = BENCHMARK_MESSAGE_LENGTH;
+
+    bomm_measure_config_destroy();
+    free(scrambler);
+    free(message);
+    return 0;
+}
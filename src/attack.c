@@ -11,9 +11,13 @@
 
 #include <math.h>
 #include "attack.h"
+#include "cache.h"
 #include "pass.h"
 #include "key.h"
-#include "enigma.h"
+#include "scrambler.h"
+#include "scheduler.h"
+#include "scratch.h"
+#include "simd.h"
 
 void* bomm_attack_thread(void* arg) {
     // The argument is assumed to be an attack
@@ -31,14 +35,36 @@ void bomm_attack_key_space(bomm_attack_t* attack) {
 
     // Allocate messages on the stack
     size_t message_size = bomm_message_size_for_length(attack->ciphertext->length);
-    bomm_message_t *plaintext = alloca(message_size);
     bomm_message_t *ciphertext = alloca(message_size);
     memcpy(ciphertext, attack->ciphertext, message_size);
 
+    // Allocate scratch buffers reused by the passes on the stack
+    bomm_scratch_t *scratch = alloca(bomm_scratch_size(ciphertext->length));
+    bomm_scratch_init(scratch, ciphertext->length);
+    bomm_message_t *plaintext =
+        bomm_scratch_plaintext(scratch, ciphertext->length);
+
     // Allocate scrambler on the stack
     bomm_scrambler_t *scrambler = alloca(bomm_scrambler_size(ciphertext->length));
     scrambler->length = ciphertext->length;
 
+    // Allocate scrambler engine on the stack
+    bomm_scrambler_engine_t *engine =
+        alloca(bomm_scrambler_engine_size(ciphertext->length));
+    bomm_scrambler_engine_init(engine, &attack->key_space, ciphertext->length);
+
+    // Allocate the scrambler cache, if enabled
+    bomm_cache_t* cache = NULL;
+    bomm_cache_entry_t* cache_entry = NULL;
+    bool cache_hit = false;
+    unsigned long long scrambler_fingerprint = BOMM_CACHE_FINGERPRINT_NONE;
+    if (
+        attack->query->cache_size > 0 &&
+        !(cache = bomm_cache_init(NULL, attack->query->cache_size))
+    ) {
+        fprintf(stderr, "Error: Out of memory, continuing without scrambler cache\n");
+    }
+
     // Copy passes on the stack
     unsigned int num_passes = attack->num_passes;
     bomm_pass_t passes[BOMM_MAX_NUM_PASSES];
@@ -48,84 +74,159 @@ void bomm_attack_key_space(bomm_attack_t* attack) {
     double batch_start_timestamp = start_timestamp;
     double batch_duration_sec;
     bool cancelling = false;
-    unsigned long num_keys = bomm_key_space_count(&attack->key_space);
+    bomm_scheduler_t* scheduler = &attack->query->scheduler;
+    unsigned long chunk_start;
+    unsigned long chunk_size;
     unsigned int num_batch_keys = 26 * 26 * 8;
     unsigned int num_batch_keys_completed = 0;
     unsigned int num_batch_decrypts = 0;
+    unsigned int num_batch_aborts = 0;
 
     bomm_key_iterator_t key_iterator;
     if (bomm_key_iterator_init(&key_iterator, &attack->key_space) == NULL) {
         // Key space is empty
+        free(cache);
         return;
     }
 
     // Initial progress update
     pthread_mutex_lock(&attack->mutex);
     attack->progress.num_batch_units = num_batch_keys;
-    attack->progress.num_units = num_keys;
+    attack->progress.num_units = 0;
     attack->progress.num_units_completed = 0;
     attack->progress.num_decrypts = 0;
+    attack->progress.num_aborts = 0;
+    attack->progress.num_cache_lookups = 0;
+    attack->progress.num_cache_hits = 0;
     attack->progress.batch_duration_sec = 0;
     attack->progress.duration_sec = 0;
+    attack->progress.tail_idle_sec = 0;
     pthread_mutex_unlock(&attack->mutex);
 
-    // Iterate over keys in the key space
-    do {
-        if (key_iterator.scrambler_changed) {
-            bomm_enigma_generate_scrambler(scrambler, &key_iterator.key);
+    // Claim chunks of keys from the scheduler until the key space is exhausted
+    while (
+        !cancelling &&
+        bomm_scheduler_claim(scheduler, &chunk_start, &chunk_size)
+    ) {
+        // Skip keys claimed by other attacks; A chunk the iterator cannot seek
+        // to lies outside the key space and holds no keys to be attacked
+        if (
+            key_iterator.index != chunk_start &&
+            bomm_key_iterator_seek(&key_iterator, chunk_start)
+        ) {
+            continue;
         }
 
-        // Make a working copy of the plugboard
-        memcpy(&plugboard, &key_iterator.key.plugboard, sizeof(plugboard));
-
-        // Iterate over passes
-        score = 0;
-        for (i = 0; i < num_passes; i++) {
-            score = bomm_pass_run(
-                &passes[i],
-                &plugboard,
-                scrambler,
-                ciphertext,
-                score,
-                &num_batch_decrypts
-            );
-            if (score > min_score) {
-                bomm_scrambler_encrypt(scrambler, &plugboard, ciphertext, plaintext);
-                bomm_message_stringify(hold_preview, sizeof(hold_preview), plaintext);
-
-                bomm_key_t key;
-                memcpy(&key, &key_iterator.key, sizeof(key));
-                memcpy(&key.plugboard, &plugboard, sizeof(plugboard));
-                min_score = bomm_hold_add(attack->query->hold, score, &key, hold_preview);
+        pthread_mutex_lock(&attack->mutex);
+        attack->progress.num_units += chunk_size;
+        pthread_mutex_unlock(&attack->mutex);
+
+        // Iterate over keys in the chunk
+        for (
+            unsigned long j = 0;
+            j < chunk_size && !cancelling;
+            j++, bomm_key_iterator_next(&key_iterator)
+        ) {
+            if (key_iterator.scrambler_changed) {
+                bomm_scrambler_engine_load(engine, &key_iterator.key, scrambler);
+                if (cache != NULL) {
+                    scrambler_fingerprint = bomm_fingerprint(
+                        scrambler->map,
+                        scrambler->length * BOMM_ALPHABET_SIZE * sizeof(bomm_letter_t),
+                        0
+                    );
+                }
+            }
+
+            // Make a working copy of the plugboard
+            memcpy(&plugboard, &key_iterator.key.plugboard, sizeof(plugboard));
+
+            // Look up the pass results for this scrambler and plugboard, if cached
+            if (cache != NULL) {
+                unsigned long long fingerprint = bomm_fingerprint(
+                    plugboard.map, sizeof(plugboard.map), scrambler_fingerprint);
+                cache_entry = bomm_cache_lookup(cache, fingerprint);
+                cache_hit = cache_entry != NULL;
+                if (!cache_hit) {
+                    cache_entry = bomm_cache_store(cache, fingerprint);
+                }
             }
-        }
 
-        // Report the progress every time a batch has been finalized
-        if (++num_batch_keys_completed >= num_batch_keys) {
-            // Measure time
-            batch_duration_sec = batch_start_timestamp;
-            batch_start_timestamp = bomm_timestamp_sec();
-            batch_duration_sec = batch_start_timestamp - batch_duration_sec;
-
-            // Intermediate progress update
-            pthread_mutex_lock(&attack->mutex);
-            attack->progress.num_units_completed += num_batch_keys_completed;
-            attack->progress.num_decrypts += num_batch_decrypts;
-            attack->progress.duration_sec = batch_start_timestamp - start_timestamp;
-            attack->progress.batch_duration_sec = batch_duration_sec;
-            cancelling = attack->state == BOMM_ATTACK_STATE_CANCELLING;
-            pthread_mutex_unlock(&attack->mutex);
-
-            // Reset counter
-            num_batch_keys_completed = 0;
-            num_batch_decrypts = 0;
+            // Iterate over passes
+            score = 0;
+            for (i = 0; i < num_passes; i++) {
+                if (cache_hit) {
+                    score = cache_entry->scores[i];
+                    memcpy(&plugboard, &cache_entry->plugboards[i], sizeof(plugboard));
+                } else {
+                    score = bomm_pass_run(
+                        &passes[i],
+                        &plugboard,
+                        scrambler,
+                        ciphertext,
+                        score,
+                        scratch,
+                        &num_batch_decrypts,
+                        &num_batch_aborts
+                    );
+                    if (cache_entry != NULL) {
+                        cache_entry->scores[i] = score;
+                        memcpy(&cache_entry->plugboards[i], &plugboard, sizeof(plugboard));
+                    }
+                }
+                if (score > min_score) {
+                    bomm_simd_encrypt(
+                        engine->simd, scrambler, &plugboard, ciphertext, plaintext);
+                    bomm_message_stringify(hold_preview, sizeof(hold_preview), plaintext);
+
+                    bomm_key_t key;
+                    memcpy(&key, &key_iterator.key, sizeof(key));
+                    memcpy(&key.plugboard, &plugboard, sizeof(plugboard));
+                    min_score = bomm_hold_add(attack->query->hold, score, &key, hold_preview);
+                }
+            }
+
+            // Report the progress every time a batch has been finalized
+            if (++num_batch_keys_completed >= num_batch_keys) {
+                // Measure time
+                batch_duration_sec = batch_start_timestamp;
+                batch_start_timestamp = bomm_timestamp_sec();
+                batch_duration_sec = batch_start_timestamp - batch_duration_sec;
+
+                // Intermediate progress update
+                pthread_mutex_lock(&attack->mutex);
+                attack->progress.num_units_completed += num_batch_keys_completed;
+                attack->progress.num_decrypts += num_batch_decrypts;
+                attack->progress.num_aborts += num_batch_aborts;
+                if (cache != NULL) {
+                    attack->progress.num_cache_lookups = cache->num_lookups;
+                    attack->progress.num_cache_hits = cache->num_hits;
+                }
+                attack->progress.duration_sec = batch_start_timestamp - start_timestamp;
+                attack->progress.batch_duration_sec = batch_duration_sec;
+                cancelling = attack->state == BOMM_ATTACK_STATE_CANCELLING;
+                pthread_mutex_unlock(&attack->mutex);
+
+                // Reset counter
+                num_batch_keys_completed = 0;
+                num_batch_decrypts = 0;
+                num_batch_aborts = 0;
+            }
         }
-    } while (!cancelling && !bomm_key_iterator_next(&key_iterator));
+    }
 
     // Final progress update
     pthread_mutex_lock(&attack->mutex);
+    attack->progress.duration_sec = bomm_timestamp_sec() - start_timestamp;
     attack->progress.num_units_completed += num_batch_keys_completed;
     attack->progress.num_decrypts += num_batch_decrypts;
+    attack->progress.num_aborts += num_batch_aborts;
+    if (cache != NULL) {
+        attack->progress.num_cache_lookups = cache->num_lookups;
+        attack->progress.num_cache_hits = cache->num_hits;
+    }
     attack->state = cancelling ? BOMM_ATTACK_STATE_CANCELLED : BOMM_ATTACK_STATE_COMPLETED;
     pthread_mutex_unlock(&attack->mutex);
+
+    free(cache);
 }
@@ -0,0 +1,28 @@
+//
+//  cache.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include "cache.h"
+
+bomm_cache_t* bomm_cache_init(bomm_cache_t* cache, unsigned int size) {
+    if (size == 0) {
+        return NULL;
+    }
+
+    if (!cache && !(cache = malloc(bomm_cache_size(size)))) {
+        return NULL;
+    }
+
+    cache->size = size;
+    cache->num_lookups = 0;
+    cache->num_hits = 0;
+
+    for (unsigned int i = 0; i < size; i++) {
+        cache->entries[i].fingerprint = BOMM_CACHE_FINGERPRINT_NONE;
+    }
+
+    return cache;
+}
@@ -0,0 +1,118 @@
+//
+//  cache.h
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#ifndef cache_h
+#define cache_h
+
+#include <stdlib.h>
+#include "query.h"
+#include "wiring.h"
+
+/**
+ * Fingerprint marking an empty cache entry
+ */
+#define BOMM_CACHE_FINGERPRINT_NONE 0
+
+/**
+ * Struct representing the pass results for a single scrambler and initial
+ * plugboard setting.
+ */
+typedef struct _bomm_cache_entry {
+    /**
+     * Fingerprint of the scrambler and initial plugboard setting
+     */
+    unsigned long long fingerprint;
+
+    /**
+     * Score after each pass
+     */
+    double scores[BOMM_MAX_NUM_PASSES];
+
+    /**
+     * Plugboard setting after each pass
+     */
+    bomm_plugboard_t plugboards[BOMM_MAX_NUM_PASSES];
+} bomm_cache_entry_t;
+
+/**
+ * Variable-size struct representing a direct-mapped cache of pass results
+ * indexed by scrambler fingerprints. Used by a single thread to detect
+ * scramblers (e.g. those of keys that only differ beyond the message length)
+ * that have already been attacked.
+ *
+ * Fingerprints are 64-bit hashes of the scrambler letter maps and the initial
+ * plugboard setting. Entries are not verified byte by byte, so a fingerprint
+ * collision would reuse unrelated pass results, which is considered unlikely
+ * enough to be neglected.
+ */
+typedef struct _bomm_cache {
+    /**
+     * Number of entries
+     */
+    unsigned int size;
+
+    /**
+     * Number of lookups so far
+     */
+    unsigned long num_lookups;
+
+    /**
+     * Number of lookups so far that hit an entry
+     */
+    unsigned long num_hits;
+
+    /**
+     * Cache entries
+     */
+    bomm_cache_entry_t entries[];
+} bomm_cache_t;
+
+/**
+ * Calculate the cache struct size for the given number of entries.
+ */
+static inline size_t bomm_cache_size(unsigned int size) {
+    return sizeof(bomm_cache_t) + size * sizeof(bomm_cache_entry_t);
+}
+
+/**
+ * Initialize a cache with the given number of entries.
+ * @param cache Pointer to a cache of size `bomm_cache_size` or NULL, if a new
+ * one should be allocated.
+ */
+bomm_cache_t* bomm_cache_init(bomm_cache_t* cache, unsigned int size);
+
+/**
+ * Look up the entry for the given fingerprint.
+ * @return Cache entry or NULL, if the fingerprint is not cached.
+ */
+static inline bomm_cache_entry_t* bomm_cache_lookup(
+    bomm_cache_t* cache,
+    unsigned long long fingerprint
+) {
+    bomm_cache_entry_t* entry = &cache->entries[fingerprint % cache->size];
+    cache->num_lookups++;
+    if (entry->fingerprint != fingerprint) {
+        return NULL;
+    }
+    cache->num_hits++;
+    return entry;
+}
+
+/**
+ * Claim the entry for the given fingerprint, evicting the entry previously
+ * stored in its place. The caller is expected to fill in the pass results.
+ */
+static inline bomm_cache_entry_t* bomm_cache_store(
+    bomm_cache_t* cache,
+    unsigned long long fingerprint
+) {
+    bomm_cache_entry_t* entry = &cache->entries[fingerprint % cache->size];
+    entry->fingerprint = fingerprint;
+    return entry;
+}
+
+#endif /* cache_h */
@@ -0,0 +1,404 @@
+//
+//  delta.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include "delta.h"
+
+/**
+ * Return the n-gram index of the window starting at the given position of the
+ * current plaintext.
+ * @param strided Whether to use the strided index layout (Sinkov measures
+ * only); Passed as a constant to specialize the function
+ */
+static inline __attribute__((always_inline)) unsigned int
+_bomm_delta_window_index(
+    const bomm_delta_t* delta,
+    unsigned int n,
+    bool strided,
+    unsigned int start
+) {
+    const bomm_letter_t* letters = &delta->letters[start];
+    unsigned int map_index = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        map_index = strided
+            ? (map_index << BOMM_NGRAM_STRIDE_BITS) | letters[i]
+            : map_index * BOMM_ALPHABET_SIZE + letters[i];
+    }
+    return map_index;
+}
+
+/**
+ * Sum up the differences in n-gram value of the affected windows between the
+ * temporarily applied and the current plaintext.
+ * @param n The n in n-gram; Passed as a constant to specialize the function
+ * @param source Passed as a constant to specialize the function
+ */
+static inline __attribute__((always_inline)) double _bomm_delta_difference(
+    const bomm_delta_t* delta,
+    unsigned int n,
+    bomm_ngram_source_t source
+) {
+    const void* data = delta->source_data;
+    double difference = 0;
+    unsigned int index;
+    uint64_t word;
+    for (unsigned int w = 0; w < delta->num_words; w++) {
+        for (word = delta->windows[w]; word != 0; word &= word - 1) {
+            index = w * BOMM_DELTA_WORD_SIZE + __builtin_ctzll(word);
+            difference +=
+                bomm_ngram_value(source, data, _bomm_delta_window_index(
+                    delta, n, source == BOMM_NGRAM_SOURCE_STRIDED, index)) -
+                bomm_ngram_value(
+                    source, data, delta->window_indices[index]);
+        }
+    }
+    return difference;
+}
+
+/**
+ * Sum up the n-gram values of all windows of the current plaintext in the
+ * same order as `bomm_measure_scrambler_sinkov` does.
+ */
+static double _bomm_delta_sum(const bomm_delta_t* delta) {
+    double sum = 0;
+    for (unsigned int start = 0; start + delta->n <= delta->length; start++) {
+        sum += bomm_ngram_value(
+            delta->source, delta->source_data, delta->window_indices[start]);
+    }
+    return sum;
+}
+
+/**
+ * Sum up `f·log2(f)` over the histogram.
+ */
+static double _bomm_delta_information(const bomm_delta_t* delta) {
+    double information = 0;
+    for (unsigned int i = 0; i < bomm_pow_map[delta->n]; i++) {
+        information += delta->information_map[delta->frequencies[i]];
+    }
+    return information;
+}
+
+/**
+ * Move a window from one n-gram to another in the histogram, updating the
+ * running sums.
+ */
+static inline void _bomm_delta_move(
+    bomm_delta_t* delta,
+    unsigned int from_index,
+    unsigned int to_index
+) {
+    unsigned int* frequencies = delta->frequencies;
+    const double* information_map = delta->information_map;
+    unsigned int from = frequencies[from_index]--;
+    delta->coincidence -= 2 * (from - 1);
+    delta->information += information_map[from - 1] - information_map[from];
+    unsigned int to = frequencies[to_index]++;
+    delta->coincidence += 2 * to;
+    delta->information += information_map[to + 1] - information_map[to];
+}
+
+/**
+ * Collect the positions whose plaintext letter may change when moving from
+ * the committed plugboard to the given one into the `affected` set and the
+ * n-gram windows covering them into the `windows` set.
+ * @return False, if no position is affected
+ */
+static bool _bomm_delta_collect(
+    bomm_delta_t* delta,
+    bomm_plugboard_t* plugboard
+) {
+    unsigned int num_words = delta->num_words;
+    uint64_t* affected = delta->affected;
+    uint64_t* windows = delta->windows;
+    bool changed = false;
+    unsigned int letter, w, k;
+
+    memset(affected, 0, num_words * sizeof(uint64_t));
+    for (letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        if (plugboard->map[letter] != delta->plugboard.map[letter]) {
+            // Positions at which the letter enters or leaves the scrambler
+            const uint64_t* cipher_set = &delta->cipher_sets[letter * num_words];
+            const uint64_t* output_set = &delta->output_sets[letter * num_words];
+            for (w = 0; w < num_words; w++) {
+                affected[w] |= cipher_set[w] | output_set[w];
+            }
+            changed = true;
+        }
+    }
+
+    if (!changed || delta->length < delta->n) {
+        return false;
+    }
+
+    // The window starting at position j covers positions j to j + n - 1
+    for (w = 0; w < num_words; w++) {
+        uint64_t next = w + 1 < num_words ? affected[w + 1] : 0;
+        windows[w] = affected[w];
+        for (k = 1; k < delta->n; k++) {
+            windows[w] |= (affected[w] >> k) | (next << (BOMM_DELTA_WORD_SIZE - k));
+        }
+    }
+
+    // Remove windows extending past the end of the message
+    unsigned int num_windows = delta->length - delta->n + 1;
+    w = num_windows / BOMM_DELTA_WORD_SIZE;
+    if (w < num_words) {
+        windows[w] &= ((uint64_t) 1 << (num_windows % BOMM_DELTA_WORD_SIZE)) - 1;
+        while (++w < num_words) {
+            windows[w] = 0;
+        }
+    }
+    return true;
+}
+
+bomm_delta_t* bomm_delta_init(
+    bomm_delta_t* delta,
+    bomm_measure_t measure,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* ciphertext
+) {
+    if (!bomm_delta_supports(measure)) {
+        return NULL;
+    }
+
+    unsigned int length = ciphertext->length;
+    if (!delta && !(delta = malloc(bomm_delta_size(length)))) {
+        return NULL;
+    }
+
+    unsigned int num_words = bomm_delta_num_words(length);
+    delta->measure = measure;
+    delta->n = measure & 0x0f;
+    delta->length = length;
+    delta->num_words = num_words;
+    delta->source = measure < BOMM_MEASURE_IC
+        ? bomm_ngram_source(delta->n)
+        : BOMM_NGRAM_SOURCE_MAP;
+    delta->source_data = bomm_ngram_source_data(delta->n, delta->source);
+    delta->scrambler = scrambler;
+    delta->ciphertext = ciphertext;
+    memcpy(&delta->plugboard, plugboard, sizeof(bomm_plugboard_t));
+
+    // Lay out the arrays in the data storage
+    delta->cipher_sets = delta->data;
+    delta->output_sets = &delta->cipher_sets[BOMM_ALPHABET_SIZE * num_words];
+    delta->affected = &delta->output_sets[BOMM_ALPHABET_SIZE * num_words];
+    delta->windows = &delta->affected[num_words];
+    delta->information_map = (double*) &delta->windows[num_words];
+    delta->window_indices = (unsigned int*) &delta->information_map[length + 1];
+    delta->letters = (bomm_letter_t*) &delta->window_indices[length];
+    delta->outputs = &delta->letters[length];
+
+    memset(
+        delta->cipher_sets,
+        0,
+        BOMM_ALPHABET_SIZE * 2 * num_words * sizeof(uint64_t)
+    );
+
+    unsigned int index;
+    for (index = 0; index < length; index++) {
+        unsigned int w = index / BOMM_DELTA_WORD_SIZE;
+        uint64_t bit = (uint64_t) 1 << (index % BOMM_DELTA_WORD_SIZE);
+        unsigned int letter = ciphertext->letters[index];
+        bomm_letter_t output = scrambler->map[index][plugboard->map[letter]];
+        delta->cipher_sets[letter * num_words + w] |= bit;
+        delta->output_sets[output * num_words + w] |= bit;
+        delta->outputs[index] = output;
+        delta->letters[index] = plugboard->map[output];
+    }
+
+    for (index = 0; index + delta->n <= length; index++) {
+        delta->window_indices[index] = _bomm_delta_window_index(
+            delta, delta->n, delta->source == BOMM_NGRAM_SOURCE_STRIDED, index);
+    }
+
+    delta->sum = 0;
+    delta->coincidence = 0;
+    delta->information = 0;
+    if (measure < BOMM_MEASURE_IC) {
+        delta->sum = _bomm_delta_sum(delta);
+    } else {
+        delta->information_map[0] = 0;
+        for (index = 1; index <= length; index++) {
+            delta->information_map[index] = index * log2(index);
+        }
+
+        memset(
+            delta->frequencies,
+            0,
+            bomm_pow_map[delta->n] * sizeof(unsigned int)
+        );
+        for (index = 0; index + delta->n <= length; index++) {
+            delta->frequencies[delta->window_indices[index]]++;
+        }
+        for (index = 0; index < bomm_pow_map[delta->n]; index++) {
+            unsigned int frequency = delta->frequencies[index];
+            delta->coincidence += frequency * (frequency - 1);
+        }
+        delta->information = _bomm_delta_information(delta);
+    }
+    return delta;
+}
+
+/**
+ * Measure the given plugboard once the affected positions are collected.
+ * @param n The n in n-gram; Passed as a constant to specialize the function
+ */
+static inline __attribute__((always_inline)) double _bomm_delta_measure(
+    bomm_delta_t* delta,
+    unsigned int n,
+    bomm_plugboard_t* plugboard
+) {
+    bomm_scrambler_t* scrambler = delta->scrambler;
+    const bomm_letter_t* ciphertext = delta->ciphertext->letters;
+    bomm_letter_t* letters = delta->letters;
+    unsigned int num_words = delta->num_words;
+    unsigned int w, index, window_index;
+    uint64_t word;
+    double score;
+
+    // Temporarily apply the plaintext letters of the given plugboard
+    for (w = 0; w < num_words; w++) {
+        for (word = delta->affected[w]; word != 0; word &= word - 1) {
+            index = w * BOMM_DELTA_WORD_SIZE + __builtin_ctzll(word);
+            letters[index] = plugboard->map[
+                scrambler->map[index][plugboard->map[ciphertext[index]]]
+            ];
+        }
+    }
+
+    if (delta->measure < BOMM_MEASURE_IC) {
+        double difference;
+        switch (delta->source) {
+            case BOMM_NGRAM_SOURCE_LEVELS8:
+                difference = _bomm_delta_difference(
+                    delta, n, BOMM_NGRAM_SOURCE_LEVELS8);
+                break;
+            case BOMM_NGRAM_SOURCE_LEVELS16:
+                difference = _bomm_delta_difference(
+                    delta, n, BOMM_NGRAM_SOURCE_LEVELS16);
+                break;
+            case BOMM_NGRAM_SOURCE_SPARSE:
+                difference = _bomm_delta_difference(
+                    delta, n, BOMM_NGRAM_SOURCE_SPARSE);
+                break;
+            case BOMM_NGRAM_SOURCE_STRIDED:
+                difference = _bomm_delta_difference(
+                    delta, n, BOMM_NGRAM_SOURCE_STRIDED);
+                break;
+            default:
+                difference = _bomm_delta_difference(
+                    delta, n, BOMM_NGRAM_SOURCE_MAP);
+                break;
+        }
+        score = bomm_ngram_score(
+            n, delta->source, delta->sum + difference, delta->length - n + 1);
+    } else {
+        // Move the affected windows in the histogram, measure, and move them
+        // back; The running sums are simply restored
+        unsigned int coincidence = delta->coincidence;
+        double information = delta->information;
+        for (w = 0; w < num_words; w++) {
+            for (word = delta->windows[w]; word != 0; word &= word - 1) {
+                index = w * BOMM_DELTA_WORD_SIZE + __builtin_ctzll(word);
+                window_index = _bomm_delta_window_index(delta, n, false, index);
+                if (window_index != delta->window_indices[index]) {
+                    _bomm_delta_move(
+                        delta, delta->window_indices[index], window_index);
+                }
+            }
+        }
+
+        score = bomm_delta_score(delta);
+
+        for (w = 0; w < num_words; w++) {
+            for (word = delta->windows[w]; word != 0; word &= word - 1) {
+                index = w * BOMM_DELTA_WORD_SIZE + __builtin_ctzll(word);
+                window_index = _bomm_delta_window_index(delta, n, false, index);
+                delta->frequencies[window_index]--;
+                delta->frequencies[delta->window_indices[index]]++;
+            }
+        }
+        delta->coincidence = coincidence;
+        delta->information = information;
+    }
+
+    // Roll back to the committed plaintext letters
+    for (w = 0; w < num_words; w++) {
+        for (word = delta->affected[w]; word != 0; word &= word - 1) {
+            index = w * BOMM_DELTA_WORD_SIZE + __builtin_ctzll(word);
+            letters[index] = delta->plugboard.map[delta->outputs[index]];
+        }
+    }
+
+    return score;
+}
+
+double bomm_delta_measure(bomm_delta_t* delta, bomm_plugboard_t* plugboard) {
+    if (!_bomm_delta_collect(delta, plugboard)) {
+        return bomm_delta_score(delta);
+    }
+    switch (delta->n) {
+        case 1: return _bomm_delta_measure(delta, 1, plugboard);
+        case 2: return _bomm_delta_measure(delta, 2, plugboard);
+        case 3: return _bomm_delta_measure(delta, 3, plugboard);
+        case 4: return _bomm_delta_measure(delta, 4, plugboard);
+        case 5: return _bomm_delta_measure(delta, 5, plugboard);
+        default: return _bomm_delta_measure(delta, 6, plugboard);
+    }
+}
+
+void bomm_delta_commit(bomm_delta_t* delta, bomm_plugboard_t* plugboard) {
+    bool changed = _bomm_delta_collect(delta, plugboard);
+    memcpy(&delta->plugboard, plugboard, sizeof(bomm_plugboard_t));
+    if (!changed) {
+        return;
+    }
+
+    bomm_scrambler_t* scrambler = delta->scrambler;
+    const bomm_letter_t* ciphertext = delta->ciphertext->letters;
+    unsigned int num_words = delta->num_words;
+    unsigned int w, index, window_index;
+    uint64_t word, bit;
+
+    for (w = 0; w < num_words; w++) {
+        for (word = delta->affected[w]; word != 0; word &= word - 1) {
+            index = w * BOMM_DELTA_WORD_SIZE + __builtin_ctzll(word);
+            bit = word & -word;
+            bomm_letter_t output =
+                scrambler->map[index][plugboard->map[ciphertext[index]]];
+            if (output != delta->outputs[index]) {
+                delta->output_sets[delta->outputs[index] * num_words + w] &= ~bit;
+                delta->output_sets[output * num_words + w] |= bit;
+                delta->outputs[index] = output;
+            }
+            delta->letters[index] = plugboard->map[output];
+        }
+    }
+
+    bool frequency = delta->measure >= BOMM_MEASURE_IC;
+    for (w = 0; w < num_words; w++) {
+        for (word = delta->windows[w]; word != 0; word &= word - 1) {
+            index = w * BOMM_DELTA_WORD_SIZE + __builtin_ctzll(word);
+            window_index = _bomm_delta_window_index(
+                delta, delta->n, delta->source == BOMM_NGRAM_SOURCE_STRIDED, index);
+            if (frequency && window_index != delta->window_indices[index]) {
+                _bomm_delta_move(
+                    delta, delta->window_indices[index], window_index);
+            }
+            delta->window_indices[index] = window_index;
+        }
+    }
+
+    // Resum from scratch to not accumulate rounding errors
+    if (frequency) {
+        delta->information = _bomm_delta_information(delta);
+    } else {
+        delta->sum = _bomm_delta_sum(delta);
+    }
+}
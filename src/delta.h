@@ -0,0 +1,241 @@
+//
+//  delta.h
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#ifndef delta_h
+#define delta_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "measure.h"
+#include "message.h"
+#include "wiring.h"
+
+/**
+ * Number of positions covered by a single position set word
+ */
+#define BOMM_DELTA_WORD_SIZE 64
+
+/**
+ * Maximum n in n-gram supported for IC and entropy measures; Bounds the size
+ * of the frequency histogram kept by the scorer.
+ */
+#define BOMM_DELTA_MAX_FREQUENCY_N 2
+
+/**
+ * Variable-size struct representing an incremental scorer for n-gram
+ * (Sinkov), IC, and entropy measures for a fixed scrambler and ciphertext.
+ *
+ * Changing the plugboard only changes the plaintext at positions at which the
+ * ciphertext letter or the scrambler output letter is affected by the change.
+ * The scorer keeps the current plaintext, the n-gram index of each window,
+ * and sets of positions per ciphertext and output letter (stored as bitsets),
+ * such that evaluating a plugboard only needs to revisit the windows covering
+ * the affected positions.
+ *
+ * For IC and entropy measures, the scorer additionally keeps the n-gram
+ * histogram along with the running sums `Σf(f-1)` and `Σf·log2(f)` that only
+ * change for the n-grams entering or leaving the histogram.
+ */
+typedef struct _bomm_delta {
+    /**
+     * Measure
+     */
+    bomm_measure_t measure;
+
+    /**
+     * The n in n-gram
+     */
+    unsigned int n;
+
+    /**
+     * Message length
+     */
+    unsigned int length;
+
+    /**
+     * Number of words per position set
+     */
+    unsigned int num_words;
+
+    /**
+     * Representation n-gram values are looked up in and the map matching it
+     * (Sinkov measures only)
+     */
+    bomm_ngram_source_t source;
+    const void* source_data;
+
+    /**
+     * Scrambler and ciphertext the scorer has been initialized for
+     */
+    bomm_scrambler_t* scrambler;
+    bomm_message_t* ciphertext;
+
+    /**
+     * Plugboard the current plaintext has been derived from
+     */
+    bomm_plugboard_t plugboard;
+
+    /**
+     * Sum of the n-gram log probabilities (or levels, if quantized) of the
+     * current plaintext (Sinkov measures only)
+     */
+    double sum;
+
+    /**
+     * Running sum `Σf(f-1)` over the histogram (IC and entropy measures only)
+     */
+    unsigned int coincidence;
+
+    /**
+     * Running sum `Σf·log2(f)` over the histogram (IC and entropy measures
+     * only)
+     */
+    double information;
+
+    /**
+     * Histogram of the n-grams in the current plaintext (IC and entropy
+     * measures only)
+     */
+    unsigned int frequencies[BOMM_ALPHABET_SIZE * BOMM_ALPHABET_SIZE];
+
+    /**
+     * Sets of positions per ciphertext letter
+     */
+    uint64_t* cipher_sets;
+
+    /**
+     * Sets of positions per scrambler output letter (i.e. the letter before
+     * passing the plugboard a second time)
+     */
+    uint64_t* output_sets;
+
+    /**
+     * Scratch sets of positions and windows affected by an evaluation
+     */
+    uint64_t* affected;
+    uint64_t* windows;
+
+    /**
+     * Lookup table for `f·log2(f)` for every possible frequency `f`
+     */
+    double* information_map;
+
+    /**
+     * N-gram index per window of the current plaintext, indexed by the window
+     * start position
+     */
+    unsigned int* window_indices;
+
+    /**
+     * Current plaintext letters
+     */
+    bomm_letter_t* letters;
+
+    /**
+     * Scrambler output letters per position
+     */
+    bomm_letter_t* outputs;
+
+    /**
+     * Storage the arrays above point into
+     */
+    uint64_t data[];
+} bomm_delta_t;
+
+/**
+ * Return the number of words per position set for the given message length.
+ */
+static inline unsigned int bomm_delta_num_words(unsigned int length) {
+    return (length + BOMM_DELTA_WORD_SIZE - 1) / BOMM_DELTA_WORD_SIZE;
+}
+
+/**
+ * Calculate the delta struct size for the given message length.
+ */
+static inline size_t bomm_delta_size(unsigned int length) {
+    return
+        sizeof(bomm_delta_t) +
+        (BOMM_ALPHABET_SIZE * 2 + 2) * bomm_delta_num_words(length) *
+            sizeof(uint64_t) +
+        (length + 1) * sizeof(double) +
+        length * sizeof(unsigned int) +
+        length * 2 * sizeof(bomm_letter_t);
+}
+
+/**
+ * Return true, if the given measure can be evaluated incrementally.
+ */
+static inline bool bomm_delta_supports(bomm_measure_t measure) {
+    if (
+        measure >= BOMM_MEASURE_SINKOV_MONOGRAM &&
+        measure <= BOMM_MEASURE_SINKOV_HEXAGRAM
+    ) {
+        return
+            bomm_ngram_map[measure] != NULL ||
+            bomm_ngram_sparse[measure] != NULL;
+    }
+    return
+        (
+            measure >= BOMM_MEASURE_IC &&
+            measure < BOMM_MEASURE_IC + BOMM_DELTA_MAX_FREQUENCY_N
+        ) || (
+            measure >= BOMM_MEASURE_ENTROPY &&
+            measure < BOMM_MEASURE_ENTROPY + BOMM_DELTA_MAX_FREQUENCY_N
+        );
+}
+
+/**
+ * Initialize an incremental scorer for the given measure, scrambler, initial
+ * plugboard, and ciphertext. The scrambler and ciphertext are referenced and
+ * need to stay unchanged while the scorer is in use.
+ * @param delta Pointer to a delta of size `bomm_delta_size` or NULL, if a new
+ * one should be allocated.
+ * @param measure Measure supported by `bomm_delta_supports`
+ */
+bomm_delta_t* bomm_delta_init(
+    bomm_delta_t* delta,
+    bomm_measure_t measure,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* ciphertext
+);
+
+/**
+ * Measure the message put through the scrambler and the given plugboard
+ * without committing to it. Matches `bomm_measure_scrambler` up to rounding.
+ */
+double bomm_delta_measure(bomm_delta_t* delta, bomm_plugboard_t* plugboard);
+
+/**
+ * Commit to the given plugboard, making it the base of future evaluations.
+ */
+void bomm_delta_commit(bomm_delta_t* delta, bomm_plugboard_t* plugboard);
+
+/**
+ * Return the score of the plugboard committed to last. Matches
+ * `bomm_measure_scrambler` exactly for Sinkov and IC measures and up to
+ * rounding for entropy measures.
+ */
+static inline double bomm_delta_score(bomm_delta_t* delta) {
+    unsigned int num_windows = delta->length - delta->n + 1;
+    if (delta->measure < BOMM_MEASURE_IC) {
+        return bomm_ngram_score(
+            delta->n, delta->source, delta->sum, num_windows);
+    } else if (delta->measure < BOMM_MEASURE_ENTROPY) {
+        return
+            (double) (bomm_pow_map[delta->n] * delta->coincidence) /
+            (double) (num_windows * (num_windows - 1));
+    } else if (delta->length >= delta->n) {
+        // Equals `-Σ(f/s)·log2(f/s)` with `s` the number of windows
+        return
+            log2(num_windows) -
+            delta->information / (double) num_windows;
+    }
+    return 0;
+}
+
+#endif /* delta_h */
@@ -15,6 +15,11 @@
 
 inline static void bomm_enigma_engage_mechanism(bomm_key_t* state);
 inline static int bomm_enigma_scramble_letter(int x, bomm_key_t* state);
+inline static void bomm_enigma_generate_letter_map(
+    bomm_letter_t* map,
+    const bomm_key_t* state,
+    const bomm_wheel_offset_maps_t* offset_maps
+);
 
 /**
  * Simulate the Enigma on the given original message and key.
@@ -62,22 +67,52 @@ inline static __attribute__((always_inline)) void bomm_enigma_generate_scrambler
     unsigned int original_positions[key->num_slots];
     memcpy(&original_positions, key->positions, sizeof(original_positions));
 
-    unsigned int index, letter;
-    for (index = 0; index < scrambler->length; index++) {
+    // Precompute the maps of the wheels placed in the slots
+    bomm_wheel_offset_maps_t offset_maps[BOMM_MAX_NUM_SLOTS];
+    for (unsigned int slot = 0; slot < key->num_slots; slot++) {
+        bomm_wheel_offset_maps_init(&offset_maps[slot], &key->wheels[slot]);
+    }
+
+    for (unsigned int index = 0; index < scrambler->length; index++) {
         // Engaging the mechanism will change the key
         bomm_enigma_engage_mechanism(key);
 
         // Create map for this index
-        for (letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
-            scrambler->map[index][letter] =
-                bomm_enigma_scramble_letter(letter, key);
-        }
+        bomm_enigma_generate_letter_map(scrambler->map[index], key, offset_maps);
     }
 
     // Reinstate original positions
     memcpy(key->positions, &original_positions, sizeof(original_positions));
 }
 
+/**
+ * Transition the given state to the next state in-place using the stepping
+ * mechanism. Used by callers that have resolved the mechanism beforehand.
+ * Assumption: Only positions are manipulated.
+ */
+inline static void bomm_enigma_engage_stepping(bomm_key_t* state) {
+    // The Enigma stepping rotation mechanism assumes 3 rotating wheels
+    // and 1 reflector.
+    if (bomm_lettermask_has(
+        &state->wheels[state->fast_wheel_slot - 1].turnovers,
+        state->positions[state->fast_wheel_slot - 1] % BOMM_ALPHABET_SIZE
+    )) {
+        // If at middle wheel turnover: Step middle and left wheels
+        // (double stepping anomaly)
+        state->positions[state->fast_wheel_slot - 1]++;
+        state->positions[state->fast_wheel_slot - 2]++;
+    } else if (bomm_lettermask_has(
+        &state->wheels[state->fast_wheel_slot].turnovers,
+        state->positions[state->fast_wheel_slot] % BOMM_ALPHABET_SIZE
+    )) {
+        // If at right wheel turnover: Step middle wheel
+        state->positions[state->fast_wheel_slot - 1]++;
+    }
+
+    // Always step right (fast) wheel
+    state->positions[state->fast_wheel_slot]++;
+}
+
 /**
  * Transition the given state to the next state in-place.
  * Assumption: Only positions are manipulated.
@@ -85,26 +120,7 @@ inline static __attribute__((always_inline)) void bomm_enigma_generate_scrambler
 inline static void bomm_enigma_engage_mechanism(bomm_key_t* state) {
     switch (state->mechanism) {
         case BOMM_MECHANISM_STEPPING: {
-            // The Enigma stepping rotation mechanism assumes 3 rotating wheels
-            // and 1 reflector.
-            if (bomm_lettermask_has(
-                &state->wheels[state->fast_wheel_slot - 1].turnovers,
-                state->positions[state->fast_wheel_slot - 1] % BOMM_ALPHABET_SIZE
-            )) {
-                // If at middle wheel turnover: Step middle and left wheels
-                // (double stepping anomaly)
-                state->positions[state->fast_wheel_slot - 1]++;
-                state->positions[state->fast_wheel_slot - 2]++;
-            } else if (bomm_lettermask_has(
-                &state->wheels[state->fast_wheel_slot].turnovers,
-                state->positions[state->fast_wheel_slot] % BOMM_ALPHABET_SIZE
-            )) {
-                // If at right wheel turnover: Step middle wheel
-                state->positions[state->fast_wheel_slot - 1]++;
-            }
-
-            // Always step right (fast) wheel
-            state->positions[state->fast_wheel_slot]++;
+            bomm_enigma_engage_stepping(state);
             break;
         }
         case BOMM_MECHANISM_ODOMETER: {
@@ -162,4 +178,45 @@ inline static int bomm_enigma_scramble_letter(int x, bomm_key_t* state) {
     return bomm_mod(x, BOMM_ALPHABET_SIZE);
 }
 
+/**
+ * Send each letter of the alphabet through the Enigma scrambler at its current
+ * state and store the resulting letter map. The effective offsets are resolved
+ * once, such that sending a letter becomes a chain of plain byte lookups.
+ * @param offset_maps Offset maps of the wheels placed in each slot
+ */
+inline static void bomm_enigma_generate_letter_map(
+    bomm_letter_t* map,
+    const bomm_key_t* state,
+    const bomm_wheel_offset_maps_t* offset_maps
+) {
+    int num_slots = state->num_slots;
+    const bomm_letter_t* slot_maps[BOMM_MAX_NUM_SLOTS];
+    const bomm_letter_t* slot_revs[BOMM_MAX_NUM_SLOTS];
+    unsigned int offset, letter;
+    int slot;
+
+    // Resolve the wheel permutations for the effective offset of each slot
+    for (slot = 0; slot < num_slots; slot++) {
+        offset = bomm_wheel_offset(state->positions[slot], state->rings[slot]);
+        slot_maps[slot] = offset_maps[slot].map[offset];
+        slot_revs[slot] = offset_maps[slot].rev[offset];
+    }
+
+    for (letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        unsigned int x = letter;
+
+        // Wheels (entry wheel, wheels right to left, reflector wheel)
+        for (slot = num_slots - 1; slot >= 0; slot--) {
+            x = slot_maps[slot][x];
+        }
+
+        // Wheels (wheels left to right, entry wheel)
+        for (slot = 1; slot < num_slots; slot++) {
+            x = slot_revs[slot][x];
+        }
+
+        map[letter] = x;
+    }
+}
+
 #endif /* enigma_h */
@@ -113,3 +113,156 @@ double bomm_hold_add(
     pthread_mutex_unlock(&hold->mutex);
     return new_score_boundary;
 }
+
+json_t* bomm_hold_to_json(bomm_hold_t* hold, bomm_hold_serialize_t serialize) {
+    json_t* hold_json = json_object();
+    json_t* elements_json = json_array();
+    bool error = hold_json == NULL || elements_json == NULL;
+
+    pthread_mutex_lock(&hold->mutex);
+    for (unsigned int i = 0; !error && i < hold->num_elements; i++) {
+        bomm_hold_element_t* element = bomm_hold_at(hold, (int) i);
+        json_t* element_json = json_object();
+        error =
+            element_json == NULL ||
+            json_array_append_new(elements_json, element_json) != 0 ||
+            json_object_set_new(element_json, "score", json_real(element->score)) != 0 ||
+            json_object_set_new(element_json, "preview", json_string(element->preview)) != 0 ||
+            json_object_set_new(element_json, "data", serialize(element->data)) != 0;
+    }
+    pthread_mutex_unlock(&hold->mutex);
+
+    error =
+        error ||
+        json_object_set_new(hold_json, "size", json_integer(hold->size)) != 0;
+
+    // The elements array is owned by the hold object from here on, even if
+    // setting it fails
+    if (error || json_object_set_new(hold_json, "elements", elements_json) != 0) {
+        if (error) {
+            json_decref(elements_json);
+        }
+        json_decref(hold_json);
+        return NULL;
+    }
+    return hold_json;
+}
+
+bool bomm_hold_add_json(
+    bomm_hold_t* hold,
+    json_t* hold_json,
+    bomm_hold_deserialize_t deserialize
+) {
+    json_t* elements_json = json_object_get(hold_json, "elements");
+    if (!json_is_array(elements_json)) {
+        fprintf(stderr, "Error: The hold is expected to be an object with the field 'elements'\n");
+        return false;
+    }
+
+    unsigned char* data = malloc(hold->data_size);
+    if (data == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return false;
+    }
+
+    bool valid = true;
+    char preview[BOMM_HOLD_PREVIEW_SIZE];
+    size_t num_elements = json_array_size(elements_json);
+    for (size_t i = 0; valid && i < num_elements; i++) {
+        json_t* element_json = json_array_get(elements_json, i);
+        json_t* score_json = json_object_get(element_json, "score");
+        json_t* preview_json = json_object_get(element_json, "preview");
+        json_t* data_json = json_object_get(element_json, "data");
+
+        valid =
+            json_is_number(score_json) &&
+            json_is_string(preview_json) &&
+            data_json != NULL &&
+            deserialize(data, data_json);
+
+        if (valid) {
+            memset(preview, 0, sizeof(preview));
+            strncpy(preview, json_string_value(preview_json), sizeof(preview) - 1);
+            bomm_hold_add(hold, json_number_value(score_json), data, preview);
+        }
+    }
+
+    free(data);
+    if (!valid) {
+        fprintf(stderr, "Error: The hold contains an invalid element\n");
+    }
+    return valid;
+}
+
+bool bomm_hold_save(
+    bomm_hold_t* hold,
+    const char* filename,
+    bomm_hold_serialize_t serialize
+) {
+    json_t* hold_json = bomm_hold_to_json(hold, serialize);
+    if (hold_json == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return false;
+    }
+    bool success = json_dump_file(hold_json, filename, JSON_INDENT(2)) == 0;
+    json_decref(hold_json);
+    if (!success) {
+        fprintf(stderr, "Error: The hold file %s cannot be written\n", filename);
+    }
+    return success;
+}
+
+bool bomm_hold_merge(
+    const char* target_filename,
+    char* const source_filenames[],
+    unsigned int num_sources,
+    size_t data_size,
+    bomm_hold_serialize_t serialize,
+    bomm_hold_deserialize_t deserialize
+) {
+    json_t* sources_json[num_sources > 0 ? num_sources : 1];
+    unsigned int num_loaded = 0;
+    unsigned int hold_size = 0;
+    bool success = num_sources > 0;
+
+    // Load the source holds and determine the merged hold size
+    while (success && num_loaded < num_sources) {
+        const char* filename = source_filenames[num_loaded];
+        json_error_t error;
+        json_t* hold_json = json_load_file(filename, 0, &error);
+        if (hold_json == NULL) {
+            fprintf(stderr, "Error: The hold file %s cannot be read: %s\n", filename, error.text);
+            success = false;
+            break;
+        }
+        sources_json[num_loaded++] = hold_json;
+
+        json_t* size_json = json_object_get(hold_json, "size");
+        if (!json_is_integer(size_json)) {
+            fprintf(stderr, "Error: The hold file %s is invalid\n", filename);
+            success = false;
+        } else if (json_integer_value(size_json) > (json_int_t) hold_size) {
+            hold_size = (unsigned int) json_integer_value(size_json);
+        }
+    }
+
+    // Add the elements of all sources to a single hold
+    bomm_hold_t* hold = NULL;
+    if (success && (hold = bomm_hold_init(NULL, data_size, hold_size)) == NULL) {
+        fprintf(stderr, "Error: The merged hold cannot be created\n");
+        success = false;
+    }
+    for (unsigned int i = 0; success && i < num_loaded; i++) {
+        success = bomm_hold_add_json(hold, sources_json[i], deserialize);
+    }
+
+    success = success && bomm_hold_save(hold, target_filename, serialize);
+
+    if (hold != NULL) {
+        bomm_hold_destroy(hold);
+    }
+    for (unsigned int i = 0; i < num_loaded; i++) {
+        json_decref(sources_json[i]);
+    }
+    return success;
+}
@@ -13,6 +13,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include <jansson.h>
 
 #define BOMM_HOLD_PREVIEW_SIZE (128 - sizeof(double))
 
@@ -71,6 +72,19 @@ typedef struct _bomm_hold {
     char elements[];
 } bomm_hold_t;
 
+/**
+ * Function exporting an element's data (e.g. a key) to a JSON value
+ * @return JSON value or NULL, if out of memory
+ */
+typedef json_t* (*bomm_hold_serialize_t)(const void* data);
+
+/**
+ * Function importing an element's data (e.g. a key) from a JSON value
+ * exported by the matching `bomm_hold_serialize_t` function
+ * @return Returns false, if the JSON value is invalid.
+ */
+typedef bool (*bomm_hold_deserialize_t)(void* data, json_t* data_json);
+
 /**
  * Initialize a hold for the given element size and hold size (i.e. the maximum
  * number of elements it should hold).
@@ -100,6 +114,53 @@ double bomm_hold_add(
     const char* preview
 );
 
+/**
+ * Export the given hold to a JSON object, such that its elements can be added
+ * to another hold (see `bomm_hold_add_json`).
+ * @param serialize Function exporting the element data
+ * @return JSON object or NULL, if out of memory
+ */
+json_t* bomm_hold_to_json(bomm_hold_t* hold, bomm_hold_serialize_t serialize);
+
+/**
+ * Add the elements of the given JSON hold object (see `bomm_hold_to_json`)
+ * to the given hold using `bomm_hold_add`.
+ * @param deserialize Function importing the element data
+ * @return False, if the JSON object or the data of an element is invalid.
+ */
+bool bomm_hold_add_json(
+    bomm_hold_t* hold,
+    json_t* hold_json,
+    bomm_hold_deserialize_t deserialize
+);
+
+/**
+ * Write the given hold to a JSON file.
+ * @param serialize Function exporting the element data
+ * @return Returns true, if the file has been written successfully.
+ */
+bool bomm_hold_save(
+    bomm_hold_t* hold,
+    const char* filename,
+    bomm_hold_serialize_t serialize
+);
+
+/**
+ * Merge the hold files at the given source paths into a single hold keeping
+ * the best elements and write it to the target path. The merged hold has the
+ * size of the largest source hold.
+ * @param data_size Size of the element data rebuilt by `deserialize`
+ * @return Returns true, if the merge succeeded.
+ */
+bool bomm_hold_merge(
+    const char* target_filename,
+    char* const source_filenames[],
+    unsigned int num_sources,
+    size_t data_size,
+    bomm_hold_serialize_t serialize,
+    bomm_hold_deserialize_t deserialize
+);
+
 /**
  * Return a pointer to the element at the given index.
  * Negative indices target elements from the end of the hold.
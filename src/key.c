@@ -22,12 +22,14 @@ bomm_key_space_t* bomm_key_space_init(
     key_space->num_slots = num_slots;
     key_space->plug_mask = BOMM_LETTERMASK_NONE;
     key_space->num_keys = 0;
+    key_space->message_length = 0;
     key_space->offset = 0;
     key_space->limit = LONG_MAX;
 
     memset(key_space->wheel_sets, 0, sizeof(key_space->wheel_sets));
 
-    for (unsigned int slot = 0; slot < num_slots; slot++) {
+    // Initialize all slots, including the unused ones, as keys copy them
+    for (unsigned int slot = 0; slot < BOMM_MAX_NUM_SLOTS; slot++) {
         key_space->ring_masks[slot] = BOMM_LETTERMASK_FIRST;
         key_space->position_masks[slot] = BOMM_LETTERMASK_FIRST;
         key_space->rotating_slots[slot] = false;
@@ -259,6 +261,467 @@ void bomm_key_space_destroy(bomm_key_space_t* key_space) {
     free(key_space);
 }
 
+/**
+ * Tables of the ring settings and positions that are not redundant (see
+ * `bomm_key_is_redundant`) for a single wheel order, allowing to count, rank,
+ * and unrank keys without enumerating them.
+ *
+ * Redundancy factorizes into independent conditions on the ring setting and
+ * position of each slot, except for the left, middle, and fast slots of the
+ * stepping mechanism: The middle wheel condition depends on the number of
+ * middle wheel steps (given by the fast wheel position) and double stepping
+ * ties the middle and fast wheel positions to the left wheel offset.
+ */
+typedef struct _bomm_key_table {
+    /**
+     * Whether the left, middle, and fast slots are coupled
+     */
+    bool coupled;
+
+    /**
+     * Left, middle, and fast slot (if coupled)
+     */
+    unsigned int left_slot;
+    unsigned int middle_slot;
+    unsigned int fast_slot;
+
+    /**
+     * Positions not being redundant on their own per slot and ring setting;
+     * Unused for the middle slot, if coupled.
+     */
+    bomm_lettermask_t positions[BOMM_MAX_NUM_SLOTS][BOMM_ALPHABET_SIZE];
+
+    /**
+     * Middle positions not being redundant per fast position and middle ring
+     * setting (if coupled)
+     */
+    bomm_lettermask_t middle_positions[BOMM_ALPHABET_SIZE][BOMM_ALPHABET_SIZE];
+
+    /**
+     * Middle positions that may double step, fast positions not at a
+     * turnover, and left positions per ring setting having a double step
+     * equivalent (if coupled); Keys matching all three are redundant.
+     */
+    bomm_lettermask_t middle_double_step;
+    bomm_lettermask_t fast_double_step;
+    bomm_lettermask_t left_double_step[BOMM_ALPHABET_SIZE];
+} _bomm_key_table_t;
+
+/**
+ * Derive the tables for the wheel order of the given key.
+ */
+static void _bomm_key_table_init(
+    _bomm_key_table_t* table,
+    const bomm_key_space_t* key_space,
+    const bomm_key_t* wheels_key
+) {
+    bomm_key_t key;
+    memcpy(&key, wheels_key, sizeof(key));
+    unsigned int length = key_space->message_length;
+    unsigned int ring, position;
+
+    table->coupled =
+        key.mechanism == BOMM_MECHANISM_STEPPING && key.fast_wheel_slot >= 2;
+    table->fast_slot = key.fast_wheel_slot;
+    table->middle_slot = key.fast_wheel_slot - 1;
+    table->left_slot = key.fast_wheel_slot - 2;
+    unsigned int fast_slot = table->fast_slot;
+    unsigned int middle_slot = table->middle_slot;
+    unsigned int left_slot = table->left_slot;
+
+    // Conditions on single slots
+    for (unsigned int slot = 0; slot < key.num_slots; slot++) {
+        for (ring = 0; ring < BOMM_ALPHABET_SIZE; ring++) {
+            table->positions[slot][ring] = BOMM_LETTERMASK_NONE;
+            if (!bomm_lettermask_has(&key_space->ring_masks[slot], ring)) {
+                continue;
+            }
+            key.rings[slot] = ring;
+            for (position = 0; position < BOMM_ALPHABET_SIZE; position++) {
+                if (!bomm_lettermask_has(&key_space->position_masks[slot], position)) {
+                    continue;
+                }
+                key.positions[slot] = position;
+                if (
+                    !bomm_key_slot_is_redundant(&key, key_space, slot) &&
+                    !(
+                        table->coupled && slot == fast_slot && length > 0 &&
+                        bomm_key_space_has_turnover_equivalent(
+                            key_space, &key, slot, length)
+                    )
+                ) {
+                    bomm_lettermask_set(&table->positions[slot][ring], position);
+                }
+            }
+        }
+    }
+
+    if (!table->coupled) {
+        return;
+    }
+
+    // The middle wheel condition depends on the number of middle wheel steps
+    unsigned int num_middle_steps[BOMM_ALPHABET_SIZE];
+    for (unsigned int fast_position = 0; fast_position < BOMM_ALPHABET_SIZE; fast_position++) {
+        key.positions[fast_slot] = fast_position;
+        num_middle_steps[fast_position] = bomm_key_num_middle_steps(&key, length);
+
+        // Reuse the masks derived for the same number of steps
+        unsigned int other = 0;
+        while (
+            other < fast_position &&
+            num_middle_steps[other] != num_middle_steps[fast_position]
+        ) {
+            other++;
+        }
+        if (other < fast_position) {
+            memcpy(
+                table->middle_positions[fast_position],
+                table->middle_positions[other],
+                sizeof(table->middle_positions[0])
+            );
+            continue;
+        }
+
+        for (ring = 0; ring < BOMM_ALPHABET_SIZE; ring++) {
+            table->middle_positions[fast_position][ring] = BOMM_LETTERMASK_NONE;
+            if (!bomm_lettermask_has(&key_space->ring_masks[middle_slot], ring)) {
+                continue;
+            }
+            key.rings[middle_slot] = ring;
+            for (position = 0; position < BOMM_ALPHABET_SIZE; position++) {
+                if (!bomm_lettermask_has(&key_space->position_masks[middle_slot], position)) {
+                    continue;
+                }
+                key.positions[middle_slot] = position;
+                if (length == 0 || !bomm_key_middle_is_redundant(
+                    &key, key_space, num_middle_steps[fast_position]
+                )) {
+                    bomm_lettermask_set(
+                        &table->middle_positions[fast_position][ring], position);
+                }
+            }
+        }
+    }
+
+    // Double stepping
+    table->middle_double_step = BOMM_LETTERMASK_NONE;
+    table->fast_double_step = BOMM_LETTERMASK_NONE;
+    for (position = 0; position < BOMM_ALPHABET_SIZE; position++) {
+        key.positions[middle_slot] = position;
+        if (bomm_key_middle_may_double_step(&key, key_space)) {
+            bomm_lettermask_set(&table->middle_double_step, position);
+        }
+        if (!bomm_lettermask_has(&key.wheels[fast_slot].turnovers, position)) {
+            bomm_lettermask_set(&table->fast_double_step, position);
+        }
+    }
+    for (ring = 0; ring < BOMM_ALPHABET_SIZE; ring++) {
+        table->left_double_step[ring] = BOMM_LETTERMASK_NONE;
+        key.rings[left_slot] = ring;
+        for (position = 0; position < BOMM_ALPHABET_SIZE; position++) {
+            key.positions[left_slot] = position;
+            if (bomm_key_left_has_double_step_equivalent(&key, key_space)) {
+                bomm_lettermask_set(&table->left_double_step[ring], position);
+            }
+        }
+    }
+}
+
+/**
+ * Count the keys of the given tables, drawing ring settings and positions
+ * from the given masks per slot.
+ */
+static unsigned long _bomm_key_table_count(
+    const _bomm_key_table_t* table,
+    unsigned int num_slots,
+    const bomm_lettermask_t* ring_masks,
+    const bomm_lettermask_t* position_masks
+) {
+    unsigned long count = 1;
+    bomm_lettermask_t mask;
+    unsigned int ring;
+
+    // Slots being independent of each other multiply
+    for (unsigned int slot = 0; slot < num_slots; slot++) {
+        if (table->coupled && (
+            slot == table->left_slot ||
+            slot == table->middle_slot ||
+            slot == table->fast_slot
+        )) {
+            continue;
+        }
+        unsigned long num_slot_keys = 0;
+        for (ring = 0; ring < BOMM_ALPHABET_SIZE; ring++) {
+            if (bomm_lettermask_has(&ring_masks[slot], ring)) {
+                mask = table->positions[slot][ring] & position_masks[slot];
+                num_slot_keys += bomm_lettermask_count(&mask);
+            }
+        }
+        count *= num_slot_keys;
+    }
+
+    if (!table->coupled || count == 0) {
+        return count;
+    }
+
+    // Count left wheel settings, with and without a double step equivalent
+    unsigned int left_slot = table->left_slot;
+    unsigned long num_left = 0;
+    unsigned long num_left_double_step = 0;
+    for (ring = 0; ring < BOMM_ALPHABET_SIZE; ring++) {
+        if (bomm_lettermask_has(&ring_masks[left_slot], ring)) {
+            mask = table->positions[left_slot][ring] & position_masks[left_slot];
+            num_left += bomm_lettermask_count(&mask);
+            mask &= table->left_double_step[ring];
+            num_left_double_step += bomm_lettermask_count(&mask);
+        }
+    }
+
+    // Combine left and middle wheel settings for each fast wheel setting,
+    // removing those being redundant by double stepping
+    unsigned int middle_slot = table->middle_slot;
+    unsigned int fast_slot = table->fast_slot;
+    unsigned long num_coupled = 0;
+    for (unsigned int position = 0; position < BOMM_ALPHABET_SIZE; position++) {
+        unsigned long num_fast = 0;
+        for (ring = 0; ring < BOMM_ALPHABET_SIZE; ring++) {
+            if (bomm_lettermask_has(&ring_masks[fast_slot], ring)) {
+                mask = table->positions[fast_slot][ring] & position_masks[fast_slot];
+                num_fast += bomm_lettermask_has(&mask, position);
+            }
+        }
+        if (num_fast == 0) {
+            continue;
+        }
+
+        unsigned long num_middle = 0;
+        unsigned long num_middle_double_step = 0;
+        for (ring = 0; ring < BOMM_ALPHABET_SIZE; ring++) {
+            if (bomm_lettermask_has(&ring_masks[middle_slot], ring)) {
+                mask =
+                    table->middle_positions[position][ring] &
+                    position_masks[middle_slot];
+                num_middle += bomm_lettermask_count(&mask);
+                mask &= table->middle_double_step;
+                num_middle_double_step += bomm_lettermask_count(&mask);
+            }
+        }
+
+        unsigned long num_settings = num_middle * num_left;
+        if (bomm_lettermask_has(&table->fast_double_step, position)) {
+            num_settings -= num_middle_double_step * num_left_double_step;
+        }
+        num_coupled += num_fast * num_settings;
+    }
+    return count * num_coupled;
+}
+
+/**
+ * Find the ring settings and positions of the key at the given index among
+ * the keys of the given tables, in the order they are enumerated in.
+ */
+static void _bomm_key_table_unrank(
+    const _bomm_key_table_t* table,
+    const bomm_key_space_t* key_space,
+    unsigned long index,
+    bomm_key_t* key
+) {
+    unsigned int num_slots = key_space->num_slots;
+    bomm_lettermask_t ring_masks[BOMM_MAX_NUM_SLOTS];
+    bomm_lettermask_t position_masks[BOMM_MAX_NUM_SLOTS];
+    memcpy(ring_masks, key_space->ring_masks, sizeof(ring_masks));
+    memcpy(position_masks, key_space->position_masks, sizeof(position_masks));
+
+    // Ring settings change slower than positions, the last slot fastest
+    for (unsigned int slot = 0; slot < num_slots; slot++) {
+        for (unsigned int ring = 0; ring < BOMM_ALPHABET_SIZE; ring++) {
+            if (bomm_lettermask_has(&key_space->ring_masks[slot], ring)) {
+                ring_masks[slot] = (bomm_lettermask_t) 1 << ring;
+                unsigned long count = _bomm_key_table_count(
+                    table, num_slots, ring_masks, position_masks);
+                if (index < count) {
+                    key->rings[slot] = ring;
+                    break;
+                }
+                index -= count;
+            }
+        }
+    }
+
+    for (unsigned int slot = 0; slot < num_slots; slot++) {
+        for (unsigned int position = 0; position < BOMM_ALPHABET_SIZE; position++) {
+            if (bomm_lettermask_has(&key_space->position_masks[slot], position)) {
+                position_masks[slot] = (bomm_lettermask_t) 1 << position;
+                unsigned long count = _bomm_key_table_count(
+                    table, num_slots, ring_masks, position_masks);
+                if (index < count) {
+                    key->positions[slot] = position;
+                    break;
+                }
+                index -= count;
+            }
+        }
+    }
+}
+
+/**
+ * Return the index of the ring settings and positions of the given key among
+ * the keys of the given tables, in the order they are enumerated in.
+ */
+static unsigned long _bomm_key_table_rank(
+    const _bomm_key_table_t* table,
+    const bomm_key_space_t* key_space,
+    const bomm_key_t* key
+) {
+    unsigned int num_slots = key_space->num_slots;
+    bomm_lettermask_t ring_masks[BOMM_MAX_NUM_SLOTS];
+    bomm_lettermask_t position_masks[BOMM_MAX_NUM_SLOTS];
+    memcpy(ring_masks, key_space->ring_masks, sizeof(ring_masks));
+    memcpy(position_masks, key_space->position_masks, sizeof(position_masks));
+
+    unsigned long index = 0;
+    for (unsigned int slot = 0; slot < num_slots; slot++) {
+        for (unsigned int ring = 0; ring < key->rings[slot]; ring++) {
+            if (bomm_lettermask_has(&key_space->ring_masks[slot], ring)) {
+                ring_masks[slot] = (bomm_lettermask_t) 1 << ring;
+                index += _bomm_key_table_count(
+                    table, num_slots, ring_masks, position_masks);
+            }
+        }
+        ring_masks[slot] = (bomm_lettermask_t) 1 << key->rings[slot];
+    }
+
+    for (unsigned int slot = 0; slot < num_slots; slot++) {
+        for (unsigned int position = 0; position < key->positions[slot]; position++) {
+            if (bomm_lettermask_has(&key_space->position_masks[slot], position)) {
+                position_masks[slot] = (bomm_lettermask_t) 1 << position;
+                index += _bomm_key_table_count(
+                    table, num_slots, ring_masks, position_masks);
+            }
+        }
+        position_masks[slot] = (bomm_lettermask_t) 1 << key->positions[slot];
+    }
+    return index;
+}
+
+/**
+ * Counts of scrambler settings per wheel order, memoized by the wheels in the
+ * middle and fast slots (the only ones whose wheels affect redundancy)
+ */
+typedef struct _bomm_key_wheels_counts {
+    bool known[BOMM_MAX_WHEEL_SET_SIZE][BOMM_MAX_WHEEL_SET_SIZE];
+    unsigned long counts[BOMM_MAX_WHEEL_SET_SIZE][BOMM_MAX_WHEEL_SET_SIZE];
+} _bomm_key_wheels_counts_t;
+
+/**
+ * Count the scrambler settings for the current wheel order of the given
+ * iterator.
+ */
+static unsigned long _bomm_key_wheels_count(
+    _bomm_key_wheels_counts_t* counts,
+    const bomm_key_iterator_t* iterator
+) {
+    const bomm_key_t* key = &iterator->key;
+    unsigned int middle = 0;
+    unsigned int fast = 0;
+    if (key->mechanism == BOMM_MECHANISM_STEPPING && key->fast_wheel_slot >= 2) {
+        middle = iterator->wheel_indices[key->fast_wheel_slot - 1];
+        fast = iterator->wheel_indices[key->fast_wheel_slot];
+    }
+    if (!counts->known[middle][fast]) {
+        _bomm_key_table_t table;
+        _bomm_key_table_init(&table, iterator->key_space, key);
+        counts->counts[middle][fast] = _bomm_key_table_count(
+            &table,
+            key->num_slots,
+            iterator->key_space->ring_masks,
+            iterator->key_space->position_masks
+        );
+        counts->known[middle][fast] = true;
+    }
+    return counts->counts[middle][fast];
+}
+
+/**
+ * Initialize the given iterator at the first valid wheel order of the given
+ * key space without touching the other settings.
+ * @return True, if the key space does not contain a valid wheel order.
+ */
+static bool _bomm_key_wheels_init(
+    bomm_key_iterator_t* iterator,
+    const bomm_key_space_t* key_space
+) {
+    iterator->key_space = key_space;
+    if (bomm_key_init(&iterator->key, key_space) == NULL) {
+        return true;
+    }
+    for (unsigned int slot = 0; slot < key_space->num_slots; slot++) {
+        if (key_space->wheel_sets[slot][0].name[0] == '\0') {
+            return true;
+        }
+    }
+    memset(&iterator->wheel_indices, 0, sizeof(iterator->wheel_indices));
+    return bomm_key_iterator_wheels_next(iterator, false);
+}
+
+/**
+ * Move the given iterator to the key at the given index, not taking into
+ * account the key space offset and limit.
+ * @return True, if the index is out of bounds.
+ */
+static bool _bomm_key_iterator_unrank(
+    bomm_key_iterator_t* iterator,
+    unsigned long index
+) {
+    const bomm_key_space_t* key_space = iterator->key_space;
+    unsigned int num_plugboards = bomm_key_space_plugboard_count(key_space);
+    unsigned long plug_index = index % num_plugboards;
+    index /= num_plugboards;
+
+    // Find the wheel order
+    _bomm_key_wheels_counts_t counts;
+    memset(&counts.known, 0, sizeof(counts.known));
+    if (_bomm_key_wheels_init(iterator, key_space)) {
+        return true;
+    }
+    unsigned long count;
+    while (index >= (count = _bomm_key_wheels_count(&counts, iterator))) {
+        index -= count;
+        if (bomm_key_iterator_wheels_next(iterator, true)) {
+            return true;
+        }
+    }
+
+    // Find the ring settings and positions
+    _bomm_key_table_t table;
+    _bomm_key_table_init(&table, key_space, &iterator->key);
+    _bomm_key_table_unrank(&table, key_space, index, &iterator->key);
+    for (unsigned int slot = 0; slot < key_space->num_slots; slot++) {
+        iterator->ring_masks[slot] = bomm_lettermask_rotate(
+            &key_space->ring_masks[slot], iterator->key.rings[slot]);
+        iterator->position_masks[slot] = bomm_lettermask_rotate(
+            &key_space->position_masks[slot], iterator->key.positions[slot]);
+    }
+
+    // Find the solo plug
+    iterator->solo_plug[0] = 0;
+    iterator->solo_plug[1] = 0;
+    for (unsigned int a = 0; plug_index > 0 && a < BOMM_ALPHABET_SIZE; a++) {
+        for (unsigned int b = a + 1; plug_index > 0 && b < BOMM_ALPHABET_SIZE; b++) {
+            if (bomm_key_space_has_solo_plug(key_space, a, b) && --plug_index == 0) {
+                iterator->solo_plug[0] = a;
+                iterator->solo_plug[1] = b;
+            }
+        }
+    }
+    bomm_swap_letter(
+        &iterator->key.plugboard.map[iterator->solo_plug[0]],
+        &iterator->key.plugboard.map[iterator->solo_plug[1]]
+    );
+    return false;
+}
+
 unsigned int bomm_key_space_slice(
     const bomm_key_space_t* key_space,
     unsigned int num_slices,
@@ -304,23 +767,18 @@ unsigned long bomm_key_space_count(
         return key_space->num_keys;
     }
 
-    // Derive a key space without plug mask
-    bomm_key_space_t key_space_no_plugs;
-    memcpy(&key_space_no_plugs, key_space, sizeof(key_space_no_plugs));
-    key_space_no_plugs.plug_mask = BOMM_LETTERMASK_NONE;
-
-    // Create a new iterator for it
-    bomm_key_iterator_t key_iterator;
-    if (bomm_key_iterator_init(&key_iterator, &key_space_no_plugs) == NULL) {
+    // Sum up the scrambler settings per wheel order
+    bomm_key_iterator_t iterator;
+    if (_bomm_key_wheels_init(&iterator, key_space)) {
         // The key space is empty
         return 0;
     }
-
-    // Count scrambler keys
-    unsigned long num_keys = 1;
-    while (!bomm_key_iterator_next(&key_iterator)) {
-        num_keys++;
-    }
+    _bomm_key_wheels_counts_t counts;
+    memset(&counts.known, 0, sizeof(counts.known));
+    unsigned long num_keys = 0;
+    do {
+        num_keys += _bomm_key_wheels_count(&counts, &iterator);
+    } while (!bomm_key_iterator_wheels_next(&iterator, true));
 
     // Multiply the scrambler keys with the number of solo plugs
     num_keys *= bomm_key_space_plugboard_count(key_space);
@@ -338,6 +796,128 @@ unsigned long bomm_key_space_count(
     return num_keys;
 }
 
+bool bomm_key_space_rank(
+    const bomm_key_space_t* key_space,
+    const bomm_key_t* key,
+    unsigned long* index
+) {
+    // Find the wheel set indices of the key
+    bomm_key_iterator_t iterator;
+    if (_bomm_key_wheels_init(&iterator, key_space)) {
+        return false;
+    }
+    unsigned int wheel_indices[BOMM_MAX_NUM_SLOTS];
+    for (unsigned int slot = 0; slot < key_space->num_slots; slot++) {
+        unsigned int i = 0;
+        while (
+            key_space->wheel_sets[slot][i].name[0] != '\0' &&
+            strcmp(key_space->wheel_sets[slot][i].name, key->wheels[slot].name) != 0
+        ) {
+            i++;
+        }
+        if (key_space->wheel_sets[slot][i].name[0] == '\0') {
+            return false;
+        }
+        wheel_indices[slot] = i;
+        if (
+            !bomm_lettermask_has(&key_space->ring_masks[slot], key->rings[slot]) ||
+            !bomm_lettermask_has(&key_space->position_masks[slot], key->positions[slot])
+        ) {
+            return false;
+        }
+    }
+    if (bomm_key_is_redundant(key, key_space)) {
+        return false;
+    }
+
+    // Find the solo plug of the key, if any
+    unsigned int plug_a = 0;
+    unsigned int plug_b = 0;
+    for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        if (key->plugboard.map[letter] != key_space->plugboard.map[letter]) {
+            plug_a = letter;
+            plug_b = key->plugboard.map[letter];
+            break;
+        }
+    }
+    unsigned long plug_index = 0;
+    if (plug_a != plug_b) {
+        if (!bomm_key_space_has_solo_plug(key_space, plug_a, plug_b)) {
+            return false;
+        }
+        for (unsigned int a = 0; a <= plug_a; a++) {
+            for (unsigned int b = a + 1; b < BOMM_ALPHABET_SIZE && (a < plug_a || b <= plug_b); b++) {
+                plug_index += bomm_key_space_has_solo_plug(key_space, a, b);
+            }
+        }
+    }
+
+    // Sum up the scrambler settings of the wheel orders enumerated before
+    _bomm_key_wheels_counts_t counts;
+    memset(&counts.known, 0, sizeof(counts.known));
+    unsigned long scrambler_index = 0;
+    while (memcmp(
+        iterator.wheel_indices,
+        wheel_indices,
+        key_space->num_slots * sizeof(unsigned int)
+    ) != 0) {
+        scrambler_index += _bomm_key_wheels_count(&counts, &iterator);
+        if (bomm_key_iterator_wheels_next(&iterator, true)) {
+            return false;
+        }
+    }
+
+    _bomm_key_table_t table;
+    _bomm_key_table_init(&table, key_space, &iterator.key);
+    scrambler_index += _bomm_key_table_rank(&table, key_space, key);
+
+    unsigned long absolute_index =
+        scrambler_index * bomm_key_space_plugboard_count(key_space) + plug_index;
+    if (
+        absolute_index < key_space->offset ||
+        absolute_index - key_space->offset >= key_space->limit
+    ) {
+        return false;
+    }
+    *index = absolute_index - key_space->offset;
+    return true;
+}
+
+bomm_key_t* bomm_key_space_unrank(
+    const bomm_key_space_t* key_space,
+    unsigned long index,
+    bomm_key_t* key
+) {
+    bomm_key_iterator_t iterator;
+    iterator.key_space = key_space;
+    if (bomm_key_iterator_seek(&iterator, index)) {
+        return NULL;
+    }
+    if (!key && !(key = malloc(sizeof(bomm_key_t)))) {
+        return NULL;
+    }
+    memcpy(key, &iterator.key, sizeof(bomm_key_t));
+    return key;
+}
+
+bool bomm_key_iterator_seek(bomm_key_iterator_t* iterator, unsigned long index) {
+    const bomm_key_space_t* key_space = iterator->key_space;
+    if (index >= key_space->limit) {
+        return true;
+    }
+
+    // Unrank into a copy to leave the iterator untouched if out of bounds
+    bomm_key_iterator_t target;
+    target.key_space = key_space;
+    if (_bomm_key_iterator_unrank(&target, key_space->offset + index)) {
+        return true;
+    }
+    memcpy(iterator, &target, sizeof(target));
+    iterator->index = index;
+    iterator->scrambler_changed = true;
+    return false;
+}
+
 bomm_key_t* bomm_key_init(bomm_key_t* key, const bomm_key_space_t* key_space) {
     bool owning = key == NULL;
     if (!key && !(key = malloc(sizeof(bomm_key_t)))) {
@@ -384,6 +964,72 @@ bomm_key_t* bomm_key_init(bomm_key_t* key, const bomm_key_space_t* key_space) {
     return key;
 }
 
+/**
+ * Read a single letter from the given JSON string.
+ * @return Returns false, if the JSON value is not a string of a single letter.
+ */
+static bool _bomm_key_letter_from_json(unsigned int* letter, json_t* letter_json) {
+    const char* string = json_string_value(letter_json);
+    if (string == NULL || strlen(string) != 1) {
+        return false;
+    }
+    *letter = bomm_message_letter_from_ascii(string[0]);
+    return *letter < BOMM_ALPHABET_SIZE;
+}
+
+bomm_key_t* bomm_key_init_with_json(bomm_key_t* key, json_t* key_json) {
+    json_t* mechanism_json = json_object_get(key_json, "mechanism");
+    json_t* slots_json = json_object_get(key_json, "slots");
+    json_t* plugboard_json = json_object_get(key_json, "plugboard");
+    if (
+        !json_is_string(mechanism_json) ||
+        !json_is_array(slots_json) ||
+        json_array_size(slots_json) > BOMM_MAX_NUM_SLOTS ||
+        !json_is_string(plugboard_json)
+    ) {
+        return NULL;
+    }
+
+    // Describe the key by a key space containing nothing but it, such that the
+    // key is laid out exactly like the ones enumerated by an iterator
+    unsigned int num_slots = (unsigned int) json_array_size(slots_json);
+    bomm_key_space_t key_space;
+    bomm_key_space_init(
+        &key_space,
+        bomm_key_mechanism_from_string(json_string_value(mechanism_json)),
+        num_slots
+    );
+    unsigned int rings[BOMM_MAX_NUM_SLOTS];
+    unsigned int positions[BOMM_MAX_NUM_SLOTS];
+
+    bool valid = bomm_plugboard_init(
+        &key_space.plugboard, json_string_value(plugboard_json)) != NULL;
+    for (unsigned int slot = 0; valid && slot < num_slots; slot++) {
+        json_t* slot_json = json_array_get(slots_json, slot);
+        json_t* wheel_json = json_object_get(slot_json, "wheel");
+        json_t* rotating_json = json_object_get(slot_json, "rotating");
+        bomm_wheel_t* wheel = &key_space.wheel_sets[slot][0];
+        valid =
+            (
+                json_is_string(wheel_json)
+                    ? bomm_wheel_init_with_name(wheel, json_string_value(wheel_json)) != NULL
+                    : json_is_object(wheel_json) &&
+                        bomm_wheel_init_with_json(wheel, wheel_json) != NULL
+            ) &&
+            _bomm_key_letter_from_json(&rings[slot], json_object_get(slot_json, "ring")) &&
+            _bomm_key_letter_from_json(&positions[slot], json_object_get(slot_json, "position")) &&
+            json_is_boolean(rotating_json);
+        key_space.rotating_slots[slot] = json_is_true(rotating_json);
+    }
+
+    if (!valid || !(key = bomm_key_init(key, &key_space))) {
+        return NULL;
+    }
+    memcpy(key->rings, rings, num_slots * sizeof(unsigned int));
+    memcpy(key->positions, positions, num_slots * sizeof(unsigned int));
+    return key;
+}
+
 bomm_key_iterator_t* bomm_key_iterator_init(
     bomm_key_iterator_t* iterator,
     const bomm_key_space_t* key_space
@@ -434,7 +1080,7 @@ bomm_key_iterator_t* bomm_key_iterator_init(
             iterator->key.rings, iterator->ring_masks, num_slots) ||
         bomm_key_iterator_positions_init(
             iterator->key.positions, iterator->position_masks, num_slots) ||
-        bomm_key_is_redundant(&iterator->key)
+        bomm_key_iterator_scrambler_next(iterator, false)
     );
 
     if (empty) {
@@ -445,12 +1091,8 @@ bomm_key_iterator_t* bomm_key_iterator_init(
     }
 
     // Skip key space offset
-    unsigned long offset = key_space->offset + 1;
-    while (--offset > 0 && !empty) {
-        // When calling `bomm_key_iterator_next` then `iterator->index` will
-        // be incremented and checked against the limit
-        iterator->index = -1;
-        empty = bomm_key_iterator_next(iterator);
+    if (key_space->offset > 0) {
+        empty = bomm_key_iterator_seek(iterator, 0);
     }
 
     if (empty) {
@@ -478,6 +1120,84 @@ void bomm_key_stringify(char* str, size_t size, bomm_key_t* key) {
     snprintf(str, size, "%s %s %s %s", wheel_order_string, rings_string, positions_string, plugboard_string);
 }
 
+/**
+ * Export the given wheel to a JSON value: Its name, if it is a known wheel, or
+ * an object describing it otherwise.
+ */
+static json_t* _bomm_key_wheel_to_json(const bomm_wheel_t* wheel) {
+    bomm_wheel_t known_wheel;
+    if (
+        bomm_wheel_init_with_name(&known_wheel, wheel->name) != NULL &&
+        memcmp(&known_wheel.wiring, &wheel->wiring, sizeof(bomm_wiring_t)) == 0 &&
+        known_wheel.turnovers == wheel->turnovers
+    ) {
+        return json_string(wheel->name);
+    }
+
+    char wiring_string[BOMM_ALPHABET_SIZE + 1];
+    bomm_wiring_stringify(wiring_string, sizeof(wiring_string), &wheel->wiring);
+    char turnovers_string[BOMM_ALPHABET_SIZE + 1];
+    bomm_lettermask_stringify(turnovers_string, sizeof(turnovers_string), &wheel->turnovers);
+
+    json_t* wheel_json = json_object();
+    if (
+        wheel_json == NULL ||
+        json_object_set_new(wheel_json, "name", json_string(wheel->name)) != 0 ||
+        json_object_set_new(wheel_json, "wiring", json_string(wiring_string)) != 0 ||
+        json_object_set_new(wheel_json, "turnovers", json_string(turnovers_string)) != 0
+    ) {
+        json_decref(wheel_json);
+        return NULL;
+    }
+    return wheel_json;
+}
+
+json_t* bomm_key_to_json(const bomm_key_t* key) {
+    char plugboard_string[128];
+    bomm_plugboard_stringify(plugboard_string, sizeof(plugboard_string), &key->plugboard);
+
+    json_t* key_json = json_object();
+    json_t* slots_json = json_array();
+    bool error = key_json == NULL || slots_json == NULL;
+
+    for (unsigned int slot = 0; !error && slot < key->num_slots; slot++) {
+        char ring_string[2] = { bomm_message_letter_to_ascii(key->rings[slot]), '\0' };
+        char position_string[2] = { bomm_message_letter_to_ascii(key->positions[slot]), '\0' };
+        json_t* slot_json = json_object();
+        error =
+            slot_json == NULL ||
+            json_array_append_new(slots_json, slot_json) != 0 ||
+            json_object_set_new(slot_json, "wheel", _bomm_key_wheel_to_json(&key->wheels[slot])) != 0 ||
+            json_object_set_new(slot_json, "ring", json_string(ring_string)) != 0 ||
+            json_object_set_new(slot_json, "position", json_string(position_string)) != 0 ||
+            json_object_set_new(slot_json, "rotating", key->rotating_slots[slot] ? json_true() : json_false()) != 0;
+    }
+
+    error =
+        error ||
+        json_object_set_new(key_json, "mechanism", json_string(bomm_key_mechanism_string(key->mechanism))) != 0 ||
+        json_object_set_new(key_json, "plugboard", json_string(plugboard_string)) != 0;
+
+    // The slots array is owned by the key object from here on, even if setting
+    // it fails
+    if (error || json_object_set_new(key_json, "slots", slots_json) != 0) {
+        if (error) {
+            json_decref(slots_json);
+        }
+        json_decref(key_json);
+        return NULL;
+    }
+    return key_json;
+}
+
+json_t* bomm_key_hold_serialize(const void* data) {
+    return bomm_key_to_json((const bomm_key_t*) data);
+}
+
+bool bomm_key_hold_deserialize(void* data, json_t* data_json) {
+    return bomm_key_init_with_json((bomm_key_t*) data, data_json) != NULL;
+}
+
 void bomm_key_wheels_stringify(char* str, size_t size, bomm_key_t* key) {
     unsigned int i = 0;
     unsigned int slot = 0;
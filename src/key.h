@@ -129,6 +129,13 @@ typedef struct _bomm_key_space {
      */
     unsigned long num_keys;
 
+    /**
+     * Number of letters the scramblers of this key space are evaluated for or
+     * 0, if unknown. If set, keys whose scramblers only differ beyond this
+     * length are considered redundant (see `bomm_key_is_redundant`).
+     */
+    unsigned int message_length;
+
     /**
      * The number of keys to be skipped at the beginning of the key space;
      * Used to split the key space; Used to split the key space in slices.
@@ -283,26 +290,75 @@ void bomm_key_space_debug(const bomm_key_space_t* key_space);
  */
 void bomm_key_space_destroy(bomm_key_space_t* key_space);
 
+/**
+ * Determine whether the given pair of letters is enumerated as a solo plug in
+ * the given key space, i.e. one of them is part of the plug mask and both are
+ * self-steckered in the key space plugboard.
+ */
+static inline bool bomm_key_space_has_solo_plug(
+    const bomm_key_space_t* key_space,
+    unsigned int a,
+    unsigned int b
+) {
+    return
+        (
+            bomm_lettermask_has(&key_space->plug_mask, a) ||
+            bomm_lettermask_has(&key_space->plug_mask, b)
+        ) &&
+        key_space->plugboard.map[a] == a &&
+        key_space->plugboard.map[b] == b;
+}
+
 /**
  * Count the number of plugboard configurations in the given key space.
  */
 static inline unsigned int bomm_key_space_plugboard_count(
     const bomm_key_space_t* key_space
 ) {
-    unsigned int num_plugboards = bomm_lettermask_count(&key_space->plug_mask);
-    return
-        (BOMM_ALPHABET_SIZE - 1) * BOMM_ALPHABET_SIZE / 2 -
-        (BOMM_ALPHABET_SIZE - 1 - num_plugboards) *
-        (BOMM_ALPHABET_SIZE - num_plugboards) / 2 + 1;
+    unsigned int num_plugboards = 1;
+    if (key_space->plug_mask == BOMM_LETTERMASK_NONE) {
+        return num_plugboards;
+    }
+    for (unsigned int a = 0; a < BOMM_ALPHABET_SIZE; a++) {
+        for (unsigned int b = a + 1; b < BOMM_ALPHABET_SIZE; b++) {
+            num_plugboards += bomm_key_space_has_solo_plug(key_space, a, b);
+        }
+    }
+    return num_plugboards;
 }
 
 /**
- * Count the number of elements in the given key space.
+ * Count the number of elements in the given key space. Scrambler settings
+ * are counted per wheel order without enumerating them.
  */
 unsigned long bomm_key_space_count(
     const bomm_key_space_t* key_space
 );
 
+/**
+ * Find the key at the given index in the given key space, i.e. the key the
+ * key iterator arrives at after the given number of steps.
+ * @param key Pointer to an existing key in memory or null, if a new key
+ * should be allocated and returned.
+ * @return Pointer to the key or NULL, if the index is out of bounds.
+ */
+bomm_key_t* bomm_key_space_unrank(
+    const bomm_key_space_t* key_space,
+    unsigned long index,
+    bomm_key_t* key
+);
+
+/**
+ * Find the index of the given key in the given key space (the inverse of
+ * `bomm_key_space_unrank`).
+ * @return False, if the key is not enumerated by the key space.
+ */
+bool bomm_key_space_rank(
+    const bomm_key_space_t* key_space,
+    const bomm_key_t* key,
+    unsigned long* index
+);
+
 /**
  * Split a key space into the given number of slices.
  * @return Actual number of slices
@@ -321,6 +377,15 @@ unsigned int bomm_key_space_slice(
  */
 bomm_key_t* bomm_key_init(bomm_key_t* key, const bomm_key_space_t* key_space);
 
+/**
+ * Initialize a key from the given JSON object (see `bomm_key_to_json`). Known
+ * wheels are referenced by name, custom wheels are described by an object like
+ * in the `wheels` field of a query.
+ * @param key Pointer to an existing key in memory or null, if a new key
+ * should be allocated and returned.
+ */
+bomm_key_t* bomm_key_init_with_json(bomm_key_t* key, json_t* key_json);
+
 /**
  * Iterate to the 'next' plugboard configuration in the key space.
  */
@@ -335,7 +400,7 @@ static inline bool bomm_key_iterator_plugboard_next(
     bool carry = false;
 
     // Unplug previous solo
-    bomm_swap(
+    bomm_swap_letter(
         &iterator->key.plugboard.map[iterator->solo_plug[0]],
         &iterator->key.plugboard.map[iterator->solo_plug[1]]
     );
@@ -364,7 +429,7 @@ static inline bool bomm_key_iterator_plugboard_next(
     ));
 
     // Plug new solo
-    bomm_swap(
+    bomm_swap_letter(
         &iterator->key.plugboard.map[iterator->solo_plug[0]],
         &iterator->key.plugboard.map[iterator->solo_plug[1]]
     );
@@ -494,42 +559,338 @@ bomm_key_iterator_t* bomm_key_iterator_init(
 );
 
 /**
- * Determine the relevancy of the given key. An irrelevant key is one that is
- * redundant, equivalent to a canonicalized version of itself.
- */
-static inline bool bomm_key_is_redundant(bomm_key_t* key) {
-    // TODO: The double stepping anomaly caused by the stepping mechanism is
-    // likely to cause such redundant keys. However, they are not trivial to
-    // identify (e.g. ignoring one middle wheel position). This needs further
-    // research and proof before it can safely be implemented.
-    (void) key;
+ * Move the given iterator to the key at the given index (relative to the key
+ * space offset) without enumerating the keys in between. Sets
+ * `scrambler_changed`.
+ * @return True, if the index is out of bounds; The iterator is left unchanged
+ * in that case.
+ */
+bool bomm_key_iterator_seek(bomm_key_iterator_t* iterator, unsigned long index);
+
+/**
+ * Determine whether the given slot is only relevant by its effective offset
+ * (position minus ring setting) as the mechanism never consults its position.
+ * This is the case for every slot but the fast and middle wheels using the
+ * stepping mechanism (whose turnovers are consulted) and for every slot
+ * without a mechanism.
+ */
+static inline bool bomm_key_slot_is_offset_only(
+    const bomm_key_t* key,
+    unsigned int slot
+) {
+    switch (key->mechanism) {
+        case BOMM_MECHANISM_STEPPING:
+            return
+                slot != key->fast_wheel_slot &&
+                slot + 1 != key->fast_wheel_slot;
+        case BOMM_MECHANISM_NONE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Determine whether the key space contains a ring setting below `ring_end`
+ * and a position for the given slot that result in the given effective offset.
+ */
+static inline bool bomm_key_space_has_offset(
+    const bomm_key_space_t* key_space,
+    unsigned int slot,
+    unsigned int offset,
+    unsigned int ring_end
+) {
+    for (unsigned int ring = 0; ring < ring_end; ring++) {
+        if (
+            bomm_lettermask_has(&key_space->ring_masks[slot], ring) &&
+            bomm_lettermask_has(
+                &key_space->position_masks[slot],
+                (offset + ring) % BOMM_ALPHABET_SIZE
+            )
+        ) {
+            return true;
+        }
+    }
     return false;
 }
 
 /**
- * Increment the given key iterator, ignoring the plugboard setting.
+ * Return the turnover pattern of a wheel starting at the given position, i.e.
+ * bit `i` is set if the wheel is at a turnover position after `i` steps. Only
+ * the first `length` steps are considered.
+ */
+static inline bomm_lettermask_t bomm_key_turnover_pattern(
+    const bomm_lettermask_t* turnovers,
+    unsigned int position,
+    unsigned int length
+) {
+    bomm_lettermask_t pattern = bomm_lettermask_rotate(turnovers, position);
+    if (length < BOMM_ALPHABET_SIZE) {
+        pattern &= ((bomm_lettermask_t) 1 << length) - 1;
+    }
+    return pattern;
+}
+
+/**
+ * Determine whether the key space contains an equivalent key for the given
+ * key that only differs in the ring setting and position of the given
+ * rotating slot, has a lower ring setting and the same effective offset, and
+ * whose wheel in that slot is at a turnover after the same number of steps
+ * (within `length` steps).
+ */
+static inline bool bomm_key_space_has_turnover_equivalent(
+    const bomm_key_space_t* key_space,
+    const bomm_key_t* key,
+    unsigned int slot,
+    unsigned int length
+) {
+    const bomm_lettermask_t* turnovers = &key->wheels[slot].turnovers;
+    unsigned int ring = key->rings[slot];
+    unsigned int offset = bomm_wheel_offset(key->positions[slot], ring);
+    bomm_lettermask_t pattern =
+        bomm_key_turnover_pattern(turnovers, key->positions[slot], length);
+    for (unsigned int other_ring = 0; other_ring < ring; other_ring++) {
+        unsigned int other_position = (offset + other_ring) % BOMM_ALPHABET_SIZE;
+        if (
+            bomm_lettermask_has(&key_space->ring_masks[slot], other_ring) &&
+            bomm_lettermask_has(&key_space->position_masks[slot], other_position) &&
+            bomm_key_turnover_pattern(turnovers, other_position, length) == pattern
+        ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Determine whether the ring setting and position of the given slot are
+ * redundant on their own, i.e. the slot is only relevant by its effective
+ * offset and the key space contains a lower ring setting for that offset.
+ */
+static inline bool bomm_key_slot_is_redundant(
+    const bomm_key_t* key,
+    const bomm_key_space_t* key_space,
+    unsigned int slot
+) {
+    return
+        bomm_key_slot_is_offset_only(key, slot) &&
+        (key_space->ring_masks[slot] & ((1 << key->rings[slot]) - 1)) &&
+        bomm_key_space_has_offset(
+            key_space,
+            slot,
+            bomm_wheel_offset(key->positions[slot], key->rings[slot]),
+            key->rings[slot]
+        );
+}
+
+/**
+ * Return the number of times the fast wheel steps the middle wheel at most
+ * within the given number of steps (stepping mechanism only).
+ */
+static inline unsigned int bomm_key_num_middle_steps(
+    const bomm_key_t* key,
+    unsigned int length
+) {
+    unsigned int fast_slot = key->fast_wheel_slot;
+    const bomm_lettermask_t* fast_turnovers = &key->wheels[fast_slot].turnovers;
+    bomm_lettermask_t fast_pattern = bomm_key_turnover_pattern(
+        fast_turnovers,
+        key->positions[fast_slot],
+        length % BOMM_ALPHABET_SIZE
+    );
+    return
+        (length / BOMM_ALPHABET_SIZE) * bomm_lettermask_count(fast_turnovers) +
+        bomm_lettermask_count(&fast_pattern);
+}
+
+/**
+ * Determine whether the middle wheel does not reach a turnover while being
+ * stepped the given number of times and the key space contains a lower ring
+ * setting for its effective offset that does not either (stepping mechanism
+ * only). Without a turnover being reached, the middle wheel only matters by
+ * its offset.
+ */
+static inline bool bomm_key_middle_is_redundant(
+    const bomm_key_t* key,
+    const bomm_key_space_t* key_space,
+    unsigned int num_middle_steps
+) {
+    if (num_middle_steps + 1 >= BOMM_ALPHABET_SIZE) {
+        return false;
+    }
+    unsigned int middle_slot = key->fast_wheel_slot - 1;
+    const bomm_lettermask_t* middle_turnovers =
+        &key->wheels[middle_slot].turnovers;
+    unsigned int ring = key->rings[middle_slot];
+    unsigned int offset = bomm_wheel_offset(key->positions[middle_slot], ring);
+    if (bomm_key_turnover_pattern(
+        middle_turnovers,
+        key->positions[middle_slot],
+        num_middle_steps + 1
+    ) != BOMM_LETTERMASK_NONE) {
+        return false;
+    }
+    for (unsigned int other_ring = 0; other_ring < ring; other_ring++) {
+        unsigned int other_position = (offset + other_ring) % BOMM_ALPHABET_SIZE;
+        if (
+            bomm_lettermask_has(
+                &key_space->ring_masks[middle_slot], other_ring) &&
+            bomm_lettermask_has(
+                &key_space->position_masks[middle_slot], other_position) &&
+            bomm_key_turnover_pattern(
+                middle_turnovers,
+                other_position,
+                num_middle_steps + 1
+            ) == BOMM_LETTERMASK_NONE
+        ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Determine whether the middle wheel double steps on the first key press,
+ * such that the key with the middle and left wheel positions advanced by one
+ * is a candidate for being canonical: The middle wheel is at a turnover
+ * position, its next position is not, and the key space contains the latter
+ * (stepping mechanism only).
+ */
+static inline bool bomm_key_middle_may_double_step(
+    const bomm_key_t* key,
+    const bomm_key_space_t* key_space
+) {
+    unsigned int middle_slot = key->fast_wheel_slot - 1;
+    const bomm_lettermask_t* middle_turnovers =
+        &key->wheels[middle_slot].turnovers;
+    unsigned int middle_position =
+        (key->positions[middle_slot] + 1) % BOMM_ALPHABET_SIZE;
+    return
+        bomm_lettermask_has(middle_turnovers, key->positions[middle_slot]) &&
+        !bomm_lettermask_has(middle_turnovers, middle_position) &&
+        bomm_lettermask_has(
+            &key_space->position_masks[middle_slot], middle_position);
+}
+
+/**
+ * Determine whether the key space contains the left wheel offset resulting
+ * from advancing the left wheel position by one (stepping mechanism only).
+ * The left wheel is only relevant by its offset, thus any ring setting may be
+ * used for the canonical key.
+ */
+static inline bool bomm_key_left_has_double_step_equivalent(
+    const bomm_key_t* key,
+    const bomm_key_space_t* key_space
+) {
+    unsigned int left_slot = key->fast_wheel_slot - 2;
+    unsigned int offset =
+        bomm_wheel_offset(key->positions[left_slot] + 1, key->rings[left_slot]);
+    return bomm_key_space_has_offset(
+        key_space, left_slot, offset, BOMM_ALPHABET_SIZE);
+}
+
+/**
+ * Determine the relevancy of the given key. An irrelevant key is one that is
+ * redundant, i.e. its scrambler sequence equals the one of a canonical key
+ * that is also contained in the key space. Wheels, ring settings, and
+ * positions are expected to be drawn from the key space.
+ *
+ * Two equivalences are considered, both of which hold for any message length:
+ * - Slots that are only relevant by their effective offset (see
+ *   `bomm_key_slot_is_offset_only`): The canonical key uses the lowest ring
+ *   setting available for that offset.
+ * - Double stepping: If the middle wheel is at a turnover position, the first
+ *   key press steps both the middle and the left wheel. Unless the fast wheel
+ *   or the next middle wheel position are at a turnover, the key resulting in
+ *   the same state after the first key press has the middle and left wheel
+ *   positions advanced by one. The latter is canonical.
+ *
+ * If the key space message length is set, the turnovers of the fast and
+ * middle wheels only matter if they are reached within the message (offset
+ * space enumeration). Among the ring settings and positions of these wheels
+ * sharing the same effective offset, only one representative per turnover
+ * phase is enumerated (the one with the lowest ring setting):
+ * - Fast wheel: Keys reaching a fast wheel turnover after the same numbers of
+ *   steps within the message step the middle wheel identically.
+ * - Middle wheel: Keys whose middle wheel does not reach a turnover while the
+ *   fast wheel advances it during the message never double step.
+ *
+ * The equivalences are split into the predicates above, such that keys can
+ * also be counted and unranked without enumerating them (see
+ * `bomm_key_space_count`).
+ */
+static inline bool bomm_key_is_redundant(
+    const bomm_key_t* key,
+    const bomm_key_space_t* key_space
+) {
+    unsigned int num_slots = key->num_slots;
+    for (unsigned int slot = 0; slot < num_slots; slot++) {
+        if (bomm_key_slot_is_redundant(key, key_space, slot)) {
+            return true;
+        }
+    }
+
+    unsigned int fast_slot = key->fast_wheel_slot;
+    if (key->mechanism != BOMM_MECHANISM_STEPPING || fast_slot < 2) {
+        return false;
+    }
+
+    unsigned int length = key_space->message_length;
+    if (length > 0 && (
+        bomm_key_space_has_turnover_equivalent(
+            key_space, key, fast_slot, length) ||
+        bomm_key_middle_is_redundant(
+            key, key_space, bomm_key_num_middle_steps(key, length))
+    )) {
+        return true;
+    }
+
+    return
+        bomm_key_middle_may_double_step(key, key_space) &&
+        !bomm_lettermask_has(
+            &key->wheels[fast_slot].turnovers, key->positions[fast_slot]) &&
+        bomm_key_left_has_double_step_equivalent(key, key_space);
+}
+
+/**
+ * Move to the next scrambler setting (wheels, ring settings, and positions)
+ * that is not redundant, ignoring the plugboard setting.
+ * @param increment If set to false, does not increment a scrambler setting
+ * that is not redundant.
  * @return Whether a full revolution was completed (carry)
  */
-static inline __attribute__((always_inline)) bool bomm_key_iterator_next(
-    bomm_key_iterator_t* iterator
+static inline bool bomm_key_iterator_scrambler_next(
+    bomm_key_iterator_t* iterator,
+    bool increment
 ) {
     bomm_key_t* key = &iterator->key;
     unsigned int num_slots = key->num_slots;
     bool carry_out = false;
-    bool scrambler_changed = false;
-    do {
-        bool plugboard_carry = bomm_key_iterator_plugboard_next(iterator);
+    while (increment || bomm_key_is_redundant(key, iterator->key_space)) {
+        increment = false;
         bool carry =
-            plugboard_carry &&
             bomm_key_iterator_positions_next(
                 key->positions, iterator->position_masks, num_slots) &&
             bomm_key_iterator_positions_next(
                 key->rings, iterator->ring_masks, num_slots) &&
             bomm_key_iterator_wheels_next(
                 iterator, true);
-        scrambler_changed = scrambler_changed || plugboard_carry;
         carry_out = carry_out || carry;
-    } while (bomm_key_is_redundant(key));
+    }
+    return carry_out;
+}
+
+/**
+ * Increment the given key iterator, ignoring the plugboard setting.
+ * @return Whether a full revolution was completed (carry)
+ */
+static inline __attribute__((always_inline)) bool bomm_key_iterator_next(
+    bomm_key_iterator_t* iterator
+) {
+    bool scrambler_changed = bomm_key_iterator_plugboard_next(iterator);
+    bool carry_out =
+        scrambler_changed &&
+        bomm_key_iterator_scrambler_next(iterator, true);
 
     iterator->index++;
     iterator->scrambler_changed = scrambler_changed;
@@ -551,6 +912,25 @@ void bomm_key_wheels_stringify(char* str, size_t size, bomm_key_t* key);
 void bomm_key_rings_stringify(char* str, size_t size, bomm_key_t* key);
 void bomm_key_positions_stringify(char* str, size_t size, bomm_key_t* key);
 
+/**
+ * Export the given key to a JSON object listing its mechanism, the wheel, ring
+ * setting, position, and rotation of each slot, and its plugboard pairs.
+ * @return JSON object or NULL, if out of memory
+ */
+json_t* bomm_key_to_json(const bomm_key_t* key);
+
+/**
+ * Export the key stored in a hold element to a JSON object (see
+ * `bomm_hold_serialize_t`)
+ */
+json_t* bomm_key_hold_serialize(const void* data);
+
+/**
+ * Import the key stored in a hold element from a JSON object (see
+ * `bomm_hold_deserialize_t`)
+ */
+bool bomm_key_hold_deserialize(void* data, json_t* data_json);
+
 /**
  * Print the contents of the given key to stdout. Useful for debugging.
  */
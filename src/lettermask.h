@@ -75,13 +75,24 @@ inline static void bomm_lettermask_clear(
 inline static unsigned int bomm_lettermask_count(
     const bomm_lettermask_t* mask
 ) {
-    bomm_lettermask_t shifting_mask = *mask;
-    unsigned int num_letters = 0;
-    while (shifting_mask != BOMM_LETTERMASK_NONE) {
-        num_letters += shifting_mask & 0x1;
-        shifting_mask = shifting_mask >> 1;
+    return (unsigned int) __builtin_popcountl(*mask);
+}
+
+/**
+ * Rotate the given mask such that letter `i` of the result equals letter
+ * `(i + shift) mod BOMM_ALPHABET_SIZE` of the original mask.
+ */
+inline static bomm_lettermask_t bomm_lettermask_rotate(
+    const bomm_lettermask_t* mask,
+    unsigned int shift
+) {
+    shift %= BOMM_ALPHABET_SIZE;
+    if (shift == 0) {
+        return *mask;
     }
-    return num_letters;
+    return
+        ((*mask >> shift) | (*mask << (BOMM_ALPHABET_SIZE - shift))) &
+        BOMM_LETTERMASK_ALL;
 }
 
 /**
@@ -6,11 +6,15 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 #include <unistd.h>
 #include <signal.h>
 #include "attack.h"
+#include "measure.h"
 #include "query.h"
+#include "simd.h"
 
 /**
  * Main query instance
@@ -30,6 +34,49 @@ void bomm_signal_handler(int signal) {
  * Command line program entry point
  */
 int main(int argc, char *argv[]) {
+    // Convert an n-gram frequency file to the binary model format
+    if (argc > 1 && strcmp(argv[1], "convert") == 0) {
+        int n = argc == 5 ? atoi(argv[2]) : 0;
+        if (n < 1 || n > 6) {
+            printf("Usage: %s convert n source.txt target.bin\n", argv[0]);
+            return 1;
+        }
+        bool success = bomm_measure_ngram_map_convert(n, argv[3], argv[4]);
+        bomm_measure_config_destroy();
+        return success ? 0 : 1;
+    }
+
+    // Verify the checksum of an n-gram model in the binary format
+    if (argc > 1 && strcmp(argv[1], "verify") == 0) {
+        int n = argc == 4 ? atoi(argv[2]) : 0;
+        if (n < 1 || n > 6) {
+            printf("Usage: %s verify n model.bin\n", argv[0]);
+            return 1;
+        }
+        bool success = bomm_measure_ngram_map_verify(n, argv[3]);
+        if (success) {
+            printf("%d-gram model %s is intact\n", n, argv[3]);
+        }
+        return success ? 0 : 1;
+    }
+
+    // Merge hold files written by several processes (e.g. shards)
+    if (argc > 1 && strcmp(argv[1], "merge") == 0) {
+        if (argc < 4) {
+            printf("Usage: %s merge target.json source.json...\n", argv[0]);
+            return 1;
+        }
+        bool success = bomm_hold_merge(
+            argv[2],
+            &argv[3],
+            (unsigned int) (argc - 3),
+            sizeof(bomm_key_t),
+            bomm_key_hold_serialize,
+            bomm_key_hold_deserialize
+        );
+        return success ? 0 : 1;
+    }
+
     // Seed PRNG
     srand((unsigned int) time(NULL));
 
@@ -42,6 +89,34 @@ int main(int argc, char *argv[]) {
     // Print out details
     printf("Hold size: %d\n", bomm_query_main->hold->size);
     printf("Concurrent attacks: %d\n", bomm_query_main->num_attacks);
+    if (bomm_query_main->num_shards > 1) {
+        printf(
+            "Shard: %d of %d (%lu keys)\n",
+            bomm_query_main->shard,
+            bomm_query_main->num_shards,
+            bomm_query_main->scheduler.num_keys
+        );
+    }
+    printf(
+        "Kernels: %s (CPU supports %s)\n",
+        bomm_simd_to_string(bomm_simd_selected()),
+        bomm_simd_to_string(bomm_simd_detect())
+    );
+
+    // Report the error quantized n-gram maps make against the float maps; The
+    // maximum error bounds the error of any Sinkov score
+    for (unsigned int n = 1; n <= 6; n++) {
+        bomm_ngram_qmap_t* qmap = bomm_ngram_qmap[n];
+        if (qmap != NULL) {
+            printf(
+                "Quantized %d-gram map: %d bit, max error %.6f, mean error %.6f\n",
+                n,
+                qmap->quantization,
+                qmap->max_error,
+                qmap->mean_error
+            );
+        }
+    }
 
     // Install signal handler
     signal(SIGINT, bomm_signal_handler);
@@ -82,11 +157,47 @@ int main(int argc, char *argv[]) {
     printf("Concurrent attacks: %d\n", bomm_query_main->num_attacks);
     printf("Number of units: %lu\n", bomm_query_main->joint_progress.num_units);
     printf("Number of decrypts: %llu\n", bomm_query_main->joint_progress.num_decrypts);
+    if (bomm_query_main->joint_progress.num_aborts > 0) {
+        bomm_progress_t* progress = &bomm_query_main->joint_progress;
+        printf(
+            "Decrypts aborted early: %llu (%.3f %%)\n",
+            progress->num_aborts,
+            (double) progress->num_aborts / progress->num_decrypts * 100
+        );
+    }
+    if (bomm_query_main->num_attacks > 1) {
+        bomm_progress_t* progress = &bomm_query_main->joint_progress;
+        printf(
+            "Tail idle time: %.3f s (%.3f %% of the attack time)\n",
+            progress->tail_idle_sec,
+            progress->duration_sec > 0
+                ? progress->tail_idle_sec /
+                    (progress->duration_sec * bomm_query_main->num_attacks) * 100
+                : 0
+        );
+    }
+    if (bomm_query_main->cache_size > 0) {
+        bomm_progress_t* progress = &bomm_query_main->joint_progress;
+        printf(
+            "Scrambler cache hits: %lu of %lu (%.3f %%)\n",
+            progress->num_cache_hits,
+            progress->num_cache_lookups,
+            progress->num_cache_lookups > 0
+                ? (double) progress->num_cache_hits / progress->num_cache_lookups * 100
+                : 0
+        );
+    }
+
+    // Write the hold for it to be merged with the holds of other processes
+    bool success = bomm_query_save_hold(bomm_query_main);
+    if (success && bomm_query_main->hold_filename != NULL) {
+        printf("Hold written to %s\n", bomm_query_main->hold_filename);
+    }
 
     // Clean up
     bomm_query_destroy(bomm_query_main);
     bomm_query_main = NULL;
     bomm_measure_config_destroy();
 
-    return 0;
+    return success ? 0 : 1;
 }
@@ -7,17 +7,48 @@
 
 #define _GNU_SOURCE
 #include <stdio.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #undef _GNU_SOURCE
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include "measure.h"
+#include "simd.h"
+#include "utility.h"
 
 bomm_ngram_map_t* bomm_ngram_map[7] = {
     NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
+bomm_ngram_qmap_t* bomm_ngram_qmap[7] = {
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+bomm_sparse_t* bomm_ngram_sparse[7] = {
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+bomm_ngram_map_entry* bomm_ngram_strided[7] = {
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+double bomm_ngram_max[7] = {
+    INFINITY, INFINITY, INFINITY, INFINITY, INFINITY, INFINITY, INFINITY
+};
+
+/**
+ * Size of the file mappings backing the n-gram maps loaded from the binary
+ * model format, or 0 for n-gram maps allocated on the heap
+ */
+static size_t _bomm_ngram_map_mapping_size[7] = {
+    0, 0, 0, 0, 0, 0, 0
+};
+
 bomm_measure_trie_config_t* bomm_measure_trie_config = NULL;
 
 const unsigned int bomm_pow_map[7] = {
@@ -33,37 +64,346 @@ const unsigned int bomm_pow_map[7] = {
     BOMM_ALPHABET_SIZE * BOMM_ALPHABET_SIZE * BOMM_ALPHABET_SIZE
 };
 
-bomm_ngram_map_t* bomm_measure_ngram_map_init(
+/**
+ * Return the size of the n-gram map struct for the given n.
+ */
+static inline size_t _bomm_measure_ngram_map_size(unsigned char n) {
+    return sizeof(bomm_ngram_map_t) + bomm_pow_map[n] * sizeof(bomm_ngram_map_entry);
+}
+
+/**
+ * Free or unmap the n-gram map stored for the given n, if any.
+ */
+static void _bomm_measure_ngram_map_release(unsigned char n) {
+    // A quantized map is derived from the map and is released along with it
+    bomm_measure_ngram_qmap_init(n, BOMM_NGRAM_QUANTIZATION_NONE);
+    if (bomm_ngram_sparse[n] != NULL) {
+        free(bomm_ngram_sparse[n]);
+        bomm_ngram_sparse[n] = NULL;
+    }
+    // Strided maps of mapped files are unmapped along with the map
+    if (bomm_ngram_strided[n] != NULL && _bomm_ngram_map_mapping_size[n] == 0) {
+        free(bomm_ngram_strided[n]);
+    }
+    bomm_ngram_strided[n] = NULL;
+    bomm_ngram_max[n] = INFINITY;
+    if (bomm_ngram_map[n] == NULL) {
+        return;
+    }
+    if (_bomm_ngram_map_mapping_size[n] > 0) {
+        munmap(
+            (unsigned char*) bomm_ngram_map[n] - sizeof(bomm_ngram_map_header_t),
+            _bomm_ngram_map_mapping_size[n]
+        );
+        _bomm_ngram_map_mapping_size[n] = 0;
+    } else {
+        free(bomm_ngram_map[n]);
+    }
+    bomm_ngram_map[n] = NULL;
+}
+
+bool bomm_measure_ngram_qmap_init(
     unsigned char n,
-    const char* filename
+    bomm_ngram_quantization_t quantization
 ) {
-    // Open file in reading mode
-    FILE* file = fopen(filename, "r");
-    if (!file) {
+    if (bomm_ngram_qmap[n] != NULL) {
+        free(bomm_ngram_qmap[n]);
+        bomm_ngram_qmap[n] = NULL;
+    }
+    if (quantization == BOMM_NGRAM_QUANTIZATION_NONE) {
+        return true;
+    }
+
+    const bomm_ngram_map_t* ngram_map = bomm_ngram_map[n];
+    if (ngram_map == NULL) {
+        fprintf(stderr, "Error quantizing %d-gram map: Map not loaded\n", n);
+        return false;
+    }
+
+    unsigned int map_size = bomm_pow_map[n];
+    size_t level_size = quantization == BOMM_NGRAM_QUANTIZATION_INT8 ? 1 : 2;
+    bomm_ngram_qmap_t* qmap = malloc(
+        sizeof(bomm_ngram_qmap_t) +
+        (map_size * level_size + sizeof(uint64_t) - 1) /
+            sizeof(uint64_t) * sizeof(uint64_t)
+    );
+    if (!qmap) {
+        fprintf(stderr, "Out of memory while quantizing %d-gram map\n", n);
+        return false;
+    }
+
+    // Spread the levels evenly over the range of log probabilities
+    unsigned int map_index;
+    double min = INFINITY;
+    double max = -INFINITY;
+    for (map_index = 0; map_index < map_size; map_index++) {
+        double value = ngram_map->map[map_index];
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+    }
+    unsigned int max_level = (1u << quantization) - 1;
+    qmap->n = n;
+    qmap->quantization = quantization;
+    qmap->offset = min;
+    qmap->scale = max > min ? (max - min) / max_level : 0;
+
+    // Round to the nearest level and keep track of the error made
+    uint8_t* levels8 = (uint8_t*) qmap->levels;
+    uint16_t* levels16 = (uint16_t*) qmap->levels;
+    double error_sum = 0;
+    qmap->max_error = 0;
+    for (map_index = 0; map_index < map_size; map_index++) {
+        double value = ngram_map->map[map_index];
+        unsigned int level = qmap->scale > 0
+            ? (unsigned int) lround((value - min) / qmap->scale)
+            : 0;
+        level = level < max_level ? level : max_level;
+        if (level_size == 1) {
+            levels8[map_index] = level;
+        } else {
+            levels16[map_index] = level;
+        }
+        double error = fabs(bomm_ngram_qmap_level_value(qmap, level) - value);
+        qmap->max_error = error > qmap->max_error ? error : qmap->max_error;
+        error_sum += error;
+    }
+    qmap->mean_error = error_sum / map_size;
+
+    bomm_ngram_qmap[n] = qmap;
+    return true;
+}
+
+/**
+ * Return true, if dense maps for the given n are additionally laid out strided,
+ * i.e. if the n and the alphabet allow for it.
+ */
+static inline bool _bomm_measure_ngram_strided_supported(unsigned char n) {
+    return
+        n <= BOMM_NGRAM_STRIDED_MAX_N &&
+        BOMM_ALPHABET_SIZE <= (1u << BOMM_NGRAM_STRIDE_BITS);
+}
+
+/**
+ * Return the size of the strided map for the given n in bytes. Sizes are
+ * multiples of the cache line size for any n >= 1.
+ */
+static inline size_t _bomm_measure_ngram_strided_size(unsigned char n) {
+    return ((size_t) bomm_ngram_strided_mask(n) + 1) * sizeof(bomm_ngram_map_entry);
+}
+
+/**
+ * Return the offset of the strided map in a file in the binary model format,
+ * i.e. the end of the dense map rounded up to a multiple of the cache line
+ * size. Mappings start at page boundaries, which keeps the strided map
+ * aligned in memory.
+ */
+static inline size_t _bomm_measure_ngram_strided_offset(unsigned char n) {
+    size_t end = sizeof(bomm_ngram_map_header_t) + _bomm_measure_ngram_map_size(n);
+    return (end + 63) / 64 * 64;
+}
+
+/**
+ * Lay out the given dense n-gram map strided into the given array of
+ * `_bomm_measure_ngram_strided_size(n)` bytes.
+ */
+static void _bomm_measure_ngram_strided_fill(
+    const bomm_ngram_map_t* ngram_map,
+    bomm_ngram_map_entry* strided
+) {
+    unsigned char n = ngram_map->n;
+    size_t num_entries = (size_t) bomm_ngram_strided_mask(n) + 1;
+    for (size_t i = 0; i < num_entries; i++) {
+        strided[i] = ngram_map->fallback;
+    }
+    for (unsigned int map_index = 0; map_index < bomm_pow_map[n]; map_index++) {
+        unsigned int strided_index = 0;
+        unsigned int rest = map_index;
+        for (unsigned int i = 0; i < n; i++) {
+            strided_index |=
+                (rest % BOMM_ALPHABET_SIZE) << (BOMM_NGRAM_STRIDE_BITS * i);
+            rest /= BOMM_ALPHABET_SIZE;
+        }
+        strided[strided_index] = ngram_map->map[map_index];
+    }
+}
+
+/**
+ * Lay out the n-gram map stored in `bomm_ngram_map[n]` strided on the heap and
+ * store it in `bomm_ngram_strided[n]`, if supported for the n. The strided map
+ * is aligned to cache lines. Failing to build it is not an error, as measures
+ * fall back to the map itself.
+ */
+static void _bomm_measure_ngram_strided_init(unsigned char n) {
+    const bomm_ngram_map_t* ngram_map = bomm_ngram_map[n];
+    if (ngram_map == NULL || !_bomm_measure_ngram_strided_supported(n)) {
+        return;
+    }
+    bomm_ngram_map_entry* strided =
+        aligned_alloc(64, _bomm_measure_ngram_strided_size(n));
+    if (!strided) {
+        return;
+    }
+    _bomm_measure_ngram_strided_fill(ngram_map, strided);
+    bomm_ngram_strided[n] = strided;
+}
+
+/**
+ * Return the largest log probability of the given dense n-gram map.
+ */
+static double _bomm_measure_ngram_map_max(const bomm_ngram_map_t* ngram_map) {
+    unsigned int map_size = bomm_pow_map[ngram_map->n];
+    double max = ngram_map->fallback;
+    for (unsigned int map_index = 0; map_index < map_size; map_index++) {
+        max = ngram_map->map[map_index] > max ? ngram_map->map[map_index] : max;
+    }
+    return max;
+}
+
+/**
+ * Map an n-gram map file in the binary model format read-only into memory and
+ * validate its header. The maps themselves are only hashed and compared against
+ * the checksum if `verify` is set, leaving their pages untouched otherwise. On
+ * success, the mapping size, the strided map (or NULL, if not supported for the
+ * n), and the largest log probability are written to `mapping_size`,
+ * `strided`, and `max`.
+ */
+static bomm_ngram_map_t* _bomm_measure_ngram_map_load(
+    unsigned char n,
+    const char* filename,
+    bool verify,
+    size_t* mapping_size,
+    bomm_ngram_map_entry** strided,
+    double* max
+) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
         fprintf(stderr, "Error opening file %s\n", filename);
         return NULL;
     }
 
-    // Initialize empty map
-    unsigned int map_size = bomm_pow_map[n];
-    size_t ngram_map_size =
-        sizeof(bomm_ngram_map_t) + map_size * sizeof(bomm_ngram_map_entry);
-    bomm_ngram_map_t* ngram_map = calloc(1, ngram_map_size);
-    if (!ngram_map) {
-        fprintf(stderr, "Out of memory while loading %d-gram map\n", n);
+    struct stat file_stat;
+    if (
+        fstat(fd, &file_stat) == -1 ||
+        (size_t) file_stat.st_size < sizeof(bomm_ngram_map_header_t)
+    ) {
+        close(fd);
+        fprintf(stderr, "Unexpected size of %d-gram file %s\n", n, filename);
         return NULL;
     }
-    ngram_map->n = n;
 
-    // Parse file
+    // Private read-only mappings of the same file share their pages with any
+    // other process mapping it, e.g. parallel workers on the same machine
+    size_t size = file_stat.st_size;
+    unsigned char* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Error mapping %d-gram file %s\n", n, filename);
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    // Large maps are accessed randomly; Huge pages reduce TLB misses where
+    // the kernel supports them for file mappings
+    madvise(data, size, MADV_HUGEPAGE);
+#endif
+
+    bomm_ngram_map_header_t header;
+    memcpy(&header, data, sizeof(header));
+    bomm_ngram_map_t* ngram_map =
+        (bomm_ngram_map_t*) (data + sizeof(bomm_ngram_map_header_t));
+
+    // Files carry a strided map exactly if this build lays out the n strided
+    bool has_strided = _bomm_measure_ngram_strided_supported(n);
+    size_t expected_size = has_strided
+        ? _bomm_measure_ngram_strided_offset(n) + _bomm_measure_ngram_strided_size(n)
+        : sizeof(bomm_ngram_map_header_t) + _bomm_measure_ngram_map_size(n);
+
+    const char* error = NULL;
+    if (memcmp(header.magic, BOMM_NGRAM_MAP_MAGIC, sizeof(header.magic)) != 0) {
+        error = "Unexpected magic bytes";
+    } else if (header.version != BOMM_NGRAM_MAP_VERSION) {
+        error = "Unsupported format version";
+    } else if (header.n != n) {
+        error = "Unexpected n";
+    } else if (header.entry_size != sizeof(bomm_ngram_map_entry)) {
+        error = "Unexpected entry size";
+    } else if (header.stride_bits != (has_strided ? BOMM_NGRAM_STRIDE_BITS : 0)) {
+        error = "Unexpected stride";
+    } else if (size != expected_size) {
+        error = "Unexpected size";
+    } else if (ngram_map->n != n) {
+        error = "Unexpected n";
+    } else if (
+        strnlen(header.alphabet, sizeof(header.alphabet)) == sizeof(header.alphabet) ||
+        strcmp(header.alphabet, BOMM_ALPHABET) != 0
+    ) {
+        error = "Alphabet mismatch";
+    } else if (verify && header.checksum != bomm_fingerprint(
+        data + sizeof(bomm_ngram_map_header_t),
+        size - sizeof(bomm_ngram_map_header_t),
+        0
+    )) {
+        error = "Checksum mismatch";
+    }
+
+    if (error != NULL) {
+        munmap(data, size);
+        fprintf(stderr, "%s in %d-gram file %s\n", error, n, filename);
+        return NULL;
+    }
+
+    *mapping_size = size;
+    *strided = has_strided
+        ? (bomm_ngram_map_entry*) (data + _bomm_measure_ngram_strided_offset(n))
+        : NULL;
+    *max = header.max;
+    return ngram_map;
+}
+
+/**
+ * Callback receiving the n-gram index and frequency of each line parsed.
+ * @return Returns false to abort parsing (e.g. on allocation failure).
+ */
+typedef bool (*_bomm_measure_ngram_callback_t)(
+    void* context,
+    unsigned int map_index,
+    double frequency
+);
+
+/**
+ * Parse callback storing a frequency in the given dense n-gram map.
+ */
+static bool _bomm_measure_ngram_map_store(
+    void* context,
+    unsigned int map_index,
+    double frequency
+) {
+    bomm_ngram_map_t* ngram_map = context;
+    ngram_map->map[map_index] = frequency;
+    return true;
+}
+
+/**
+ * Parse an n-gram frequency file in the text format line by line, passing each
+ * n-gram to the given callback and determining the frequency sum and minimum.
+ * @return Returns false, if the file could not be parsed.
+ */
+static bool _bomm_measure_ngram_file_parse(
+    FILE* file,
+    unsigned char n,
+    _bomm_measure_ngram_callback_t callback,
+    void* context,
+    double* frequency_sum,
+    double* frequency_min
+) {
     size_t line_restrict = 32;
     ssize_t line_size;
     char line[line_restrict];
     char* line_buffer = (char*) &line;
     char ascii;
     bomm_letter_t letter;
-    double frequency_sum = 0;
-    double frequency_min = INFINITY;
+    *frequency_sum = 0;
+    *frequency_min = INFINITY;
     unsigned int state = 0;
     while (state == 0 && (line_size = getline(&line_buffer, &line_restrict, file)) != -1) {
         // Reset state
@@ -94,32 +434,92 @@ bomm_ngram_map_t* bomm_measure_ngram_map_init(
 
         // Store frequency
         if (state == n) {
-            ngram_map->map[map_index] = frequency;
-            frequency_sum += frequency;
-            frequency_min = frequency < frequency_min ? frequency : frequency_min;
+            if (!callback(context, map_index, frequency)) {
+                return false;
+            }
+            *frequency_sum += frequency;
+            *frequency_min = frequency < *frequency_min ? frequency : *frequency_min;
             state = 0;
         }
     }
+    return state != 255 && *frequency_sum != 0;
+}
 
-    // Close file
-    fclose(file);
-
-    // Handle parsing error
-    if (state == 255 || frequency_sum == 0) {
-        free(ngram_map);
-        fprintf(stderr, "Error parsing %d-gram file %s\n", n, filename);
-        return NULL;
-    }
-
+/**
+ * Return the probability assigned to n-grams not listed in a frequency file.
+ */
+static double _bomm_measure_ngram_fallback_probability(
+    double frequency_sum,
+    double frequency_min
+) {
     // When an n-gram is not listed in the dictionary, we would get
     // a probability of 0, leading to the worst possible penalty of -inf in our
     // fitness function. However, the actual probability of such an n-gram
     // appearing is not 0. That's why we set a fallback probability for these
     // cases to a value smaller than the minimum probability
     double min_probability = frequency_min / frequency_sum;
-    double fallback_probability = min_probability * 0.5;
+    return min_probability * 0.5;
+}
+
+bomm_ngram_map_t* bomm_measure_ngram_map_init(
+    unsigned char n,
+    const char* filename
+) {
+    // Open file in reading mode
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        return NULL;
+    }
+
+    // Map files in the binary model format instead of parsing them
+    char magic[sizeof(BOMM_NGRAM_MAP_MAGIC) - 1];
+    if (
+        fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+        memcmp(magic, BOMM_NGRAM_MAP_MAGIC, sizeof(magic)) == 0
+    ) {
+        fclose(file);
+        size_t mapping_size = 0;
+        bomm_ngram_map_entry* strided;
+        double max;
+        bomm_ngram_map_t* ngram_map = _bomm_measure_ngram_map_load(
+            n, filename, false, &mapping_size, &strided, &max);
+        if (ngram_map) {
+            _bomm_measure_ngram_map_release(n);
+            bomm_ngram_map[n] = ngram_map;
+            bomm_ngram_strided[n] = strided;
+            _bomm_ngram_map_mapping_size[n] = mapping_size;
+            bomm_ngram_max[n] = max;
+        }
+        return ngram_map;
+    }
+    rewind(file);
+
+    // Initialize empty map
+    unsigned int map_size = bomm_pow_map[n];
+    bomm_ngram_map_t* ngram_map = calloc(1, _bomm_measure_ngram_map_size(n));
+    if (!ngram_map) {
+        fclose(file);
+        fprintf(stderr, "Out of memory while loading %d-gram map\n", n);
+        return NULL;
+    }
+    ngram_map->n = n;
+
+    // Parse file
+    double frequency_sum, frequency_min;
+    bool success = _bomm_measure_ngram_file_parse(
+        file, n, _bomm_measure_ngram_map_store, ngram_map,
+        &frequency_sum, &frequency_min);
+    fclose(file);
+    if (!success) {
+        free(ngram_map);
+        fprintf(stderr, "Error parsing %d-gram file %s\n", n, filename);
+        return NULL;
+    }
 
     // Turn frequencies into log probabilities
+    double fallback_probability =
+        _bomm_measure_ngram_fallback_probability(frequency_sum, frequency_min);
     double probability;
     for (unsigned int map_index = 0; map_index < map_size; map_index++) {
         probability = ngram_map->map[map_index] / frequency_sum;
@@ -127,26 +527,618 @@ bomm_ngram_map_t* bomm_measure_ngram_map_init(
             (bomm_ngram_map_entry)
             log(probability > 0 ? probability : fallback_probability);
     }
+    ngram_map->fallback = (bomm_ngram_map_entry) log(fallback_probability);
 
+    _bomm_measure_ngram_map_release(n);
     bomm_ngram_map[n] = ngram_map;
+    bomm_ngram_max[n] = _bomm_measure_ngram_map_max(ngram_map);
+    _bomm_measure_ngram_strided_init(n);
     return ngram_map;
 }
 
+/**
+ * N-gram entries collected while parsing a file for a sparse map
+ */
+typedef struct _bomm_measure_ngram_entries {
+    unsigned int num_entries;
+    unsigned int capacity;
+    uint32_t* keys;
+    float* frequencies;
+} _bomm_measure_ngram_entries_t;
+
+/**
+ * Parse callback appending an n-gram entry to the given entries.
+ */
+static bool _bomm_measure_ngram_entries_append(
+    void* context,
+    unsigned int map_index,
+    double frequency
+) {
+    _bomm_measure_ngram_entries_t* entries = context;
+    if (entries->num_entries == entries->capacity) {
+        unsigned int capacity = entries->capacity > 0 ? entries->capacity * 2 : 1024;
+        uint32_t* keys = realloc(entries->keys, capacity * sizeof(uint32_t));
+        if (keys) {
+            entries->keys = keys;
+        }
+        float* frequencies = realloc(entries->frequencies, capacity * sizeof(float));
+        if (frequencies) {
+            entries->frequencies = frequencies;
+        }
+        if (!keys || !frequencies) {
+            return false;
+        }
+        entries->capacity = capacity;
+    }
+    // Frequencies are stored as floats like in the dense map
+    entries->keys[entries->num_entries] = map_index;
+    entries->frequencies[entries->num_entries] = (float) frequency;
+    entries->num_entries++;
+    return true;
+}
+
+bomm_sparse_t* bomm_measure_ngram_sparse_init(
+    unsigned char n,
+    const char* filename
+) {
+    // Open file in reading mode
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        return NULL;
+    }
+
+    // Collect the n-grams listed
+    _bomm_measure_ngram_entries_t entries = { 0, 0, NULL, NULL };
+    double frequency_sum, frequency_min;
+    bool success = _bomm_measure_ngram_file_parse(
+        file, n, _bomm_measure_ngram_entries_append, &entries,
+        &frequency_sum, &frequency_min);
+    fclose(file);
+
+    // Turn frequencies into log probabilities the same way the dense map does
+    bomm_sparse_t* sparse = NULL;
+    double max = -INFINITY;
+    if (success) {
+        double fallback_probability =
+            _bomm_measure_ngram_fallback_probability(frequency_sum, frequency_min);
+        double probability;
+        for (unsigned int i = 0; i < entries.num_entries; i++) {
+            probability = entries.frequencies[i] / frequency_sum;
+            entries.frequencies[i] =
+                (bomm_ngram_map_entry)
+                log(probability > 0 ? probability : fallback_probability);
+            max = entries.frequencies[i] > max ? entries.frequencies[i] : max;
+        }
+        sparse = bomm_sparse_init(
+            entries.keys,
+            entries.frequencies,
+            entries.num_entries,
+            (bomm_ngram_map_entry) log(fallback_probability)
+        );
+        if (!sparse) {
+            fprintf(stderr, "Out of memory while loading sparse %d-gram map\n", n);
+        }
+    } else {
+        fprintf(stderr, "Error parsing %d-gram file %s\n", n, filename);
+    }
+
+    free(entries.keys);
+    free(entries.frequencies);
+    if (sparse) {
+        _bomm_measure_ngram_map_release(n);
+        bomm_ngram_sparse[n] = sparse;
+        bomm_ngram_max[n] = max > sparse->fallback ? max : sparse->fallback;
+    }
+    return sparse;
+}
+
+bool bomm_measure_ngram_model_init(unsigned char n, const char* filename) {
+    // Check for the binary model format
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        return false;
+    }
+    char magic[sizeof(BOMM_NGRAM_MAP_MAGIC) - 1];
+    bool binary =
+        fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+        memcmp(magic, BOMM_NGRAM_MAP_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+
+    if (!binary && n >= BOMM_NGRAM_SPARSE_MIN_N) {
+        return bomm_measure_ngram_sparse_init(n, filename) != NULL;
+    }
+    return bomm_measure_ngram_map_init(n, filename) != NULL;
+}
+
+bool bomm_measure_ngram_map_save(
+    const bomm_ngram_map_t* ngram_map,
+    const char* filename
+) {
+    unsigned char n = ngram_map->n;
+    bomm_ngram_map_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BOMM_NGRAM_MAP_MAGIC, sizeof(header.magic));
+    header.version = BOMM_NGRAM_MAP_VERSION;
+    header.n = n;
+    header.entry_size = sizeof(bomm_ngram_map_entry);
+    header.fallback = ngram_map->fallback;
+    header.max = _bomm_measure_ngram_map_max(ngram_map);
+    if (strlen(BOMM_ALPHABET) >= sizeof(header.alphabet)) {
+        fprintf(stderr, "Alphabet too long for the binary model format\n");
+        return false;
+    }
+    strcpy(header.alphabet, BOMM_ALPHABET);
+
+    // The maps following the header are written from a single buffer; Only
+    // maps that are laid out strided (and thus small) need to be copied
+    size_t size = _bomm_measure_ngram_map_size(n);
+    const unsigned char* body = (const unsigned char*) ngram_map;
+    unsigned char* buffer = NULL;
+    if (_bomm_measure_ngram_strided_supported(n)) {
+        size_t strided_start =
+            _bomm_measure_ngram_strided_offset(n) - sizeof(bomm_ngram_map_header_t);
+        size = strided_start + _bomm_measure_ngram_strided_size(n);
+        buffer = calloc(1, size);
+        if (!buffer) {
+            fprintf(stderr, "Out of memory while saving %d-gram map\n", n);
+            return false;
+        }
+        memcpy(buffer, ngram_map, _bomm_measure_ngram_map_size(n));
+        _bomm_measure_ngram_strided_fill(
+            ngram_map, (bomm_ngram_map_entry*) (buffer + strided_start));
+        body = buffer;
+    }
+
+    header.stride_bits = buffer != NULL ? BOMM_NGRAM_STRIDE_BITS : 0;
+    header.checksum = bomm_fingerprint(body, size, 0);
+
+    FILE* file = fopen(filename, "wb");
+    bool success =
+        file != NULL &&
+        fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(body, size, 1, file) == 1;
+    success = (file == NULL || fclose(file) == 0) && success;
+    free(buffer);
+    if (!success) {
+        fprintf(stderr, "Error writing file %s\n", filename);
+    }
+    return success;
+}
+
+bool bomm_measure_ngram_map_verify(unsigned char n, const char* filename) {
+    size_t mapping_size = 0;
+    bomm_ngram_map_entry* strided;
+    double max;
+    bomm_ngram_map_t* ngram_map = _bomm_measure_ngram_map_load(
+        n, filename, true, &mapping_size, &strided, &max);
+    if (!ngram_map) {
+        return false;
+    }
+    munmap(
+        (unsigned char*) ngram_map - sizeof(bomm_ngram_map_header_t),
+        mapping_size
+    );
+    return true;
+}
+
+bool bomm_measure_ngram_map_convert(
+    unsigned char n,
+    const char* source_filename,
+    const char* target_filename
+) {
+    bomm_ngram_map_t* ngram_map =
+        bomm_measure_ngram_map_init(n, source_filename);
+    return
+        ngram_map != NULL &&
+        bomm_measure_ngram_map_save(ngram_map, target_filename) &&
+        bomm_measure_ngram_map_verify(n, target_filename);
+}
+
+/**
+ * Batch kernel body specialized on the n-gram source.
+ * @param source Passed as a constant to specialize the function
+ */
+static inline __attribute__((always_inline)) void
+_bomm_measure_scrambler_sinkov_batch(
+    unsigned int n,
+    bomm_ngram_source_t source,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* const* plugboards,
+    unsigned int num_plugboards,
+    bomm_message_t* message,
+    unsigned int distance,
+    double* sums
+) {
+    const void* data = bomm_ngram_source_data(n, source);
+    unsigned int length = message->length;
+    unsigned int num_windows = length - n + 1;
+    unsigned int indices[num_plugboards][num_windows];
+    unsigned int c, index, letter, window;
+
+    // Compute the n-gram indices of all candidates first; Indices are derived
+    // from the plaintext per window, avoiding a loop-carried rolling index
+    bomm_letter_t letters[length];
+    for (c = 0; c < num_plugboards; c++) {
+        const bomm_plugboard_t* plugboard = plugboards[c];
+        for (index = 0; index < length; index++) {
+            letter = message->letters[index];
+            letter = plugboard->map[letter];
+            letter = scrambler->map[index][letter];
+            letters[index] = plugboard->map[letter];
+        }
+        for (window = 0; window < num_windows; window++) {
+            unsigned int map_index = 0;
+            for (index = window; index < window + n; index++) {
+                map_index = source == BOMM_NGRAM_SOURCE_STRIDED
+                    ? (map_index << BOMM_NGRAM_STRIDE_BITS) | letters[index]
+                    : map_index * BOMM_ALPHABET_SIZE + letters[index];
+            }
+            indices[c][window] = map_index;
+        }
+    }
+
+    // Visit the candidates interleaved, such that their lookups overlap
+    double batch_sums[BOMM_MEASURE_MAX_BATCH_SIZE] = { 0 };
+    unsigned int prefetch_end = num_windows > distance ? num_windows - distance : 0;
+    for (window = 0; window < num_windows; window++) {
+        if (distance > 0 && window < prefetch_end) {
+            for (c = 0; c < num_plugboards; c++) {
+                bomm_ngram_prefetch(source, data, indices[c][window + distance]);
+            }
+        }
+        for (c = 0; c < num_plugboards; c++) {
+            batch_sums[c] += bomm_ngram_value(source, data, indices[c][window]);
+        }
+    }
+    for (c = 0; c < num_plugboards; c++) {
+        sums[c] = batch_sums[c];
+    }
+}
+
+void bomm_measure_scrambler_sinkov_batch(
+    unsigned int n,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* const* plugboards,
+    unsigned int num_plugboards,
+    bomm_message_t* message,
+    unsigned int distance,
+    double* scores
+) {
+    if (message->length < n) {
+        for (unsigned int c = 0; c < num_plugboards; c++) {
+            scores[c] = 0;
+        }
+        return;
+    }
+    bomm_ngram_source_t source = bomm_ngram_source(n);
+    unsigned int num_windows = message->length - n + 1;
+    while (num_plugboards > 0) {
+        unsigned int batch_size = num_plugboards < BOMM_MEASURE_MAX_BATCH_SIZE
+            ? num_plugboards
+            : BOMM_MEASURE_MAX_BATCH_SIZE;
+        switch (source) {
+            case BOMM_NGRAM_SOURCE_LEVELS8:
+                _bomm_measure_scrambler_sinkov_batch(
+                    n, BOMM_NGRAM_SOURCE_LEVELS8, scrambler, plugboards,
+                    batch_size, message, distance, scores);
+                break;
+            case BOMM_NGRAM_SOURCE_LEVELS16:
+                _bomm_measure_scrambler_sinkov_batch(
+                    n, BOMM_NGRAM_SOURCE_LEVELS16, scrambler, plugboards,
+                    batch_size, message, distance, scores);
+                break;
+            case BOMM_NGRAM_SOURCE_SPARSE:
+                _bomm_measure_scrambler_sinkov_batch(
+                    n, BOMM_NGRAM_SOURCE_SPARSE, scrambler, plugboards,
+                    batch_size, message, distance, scores);
+                break;
+            case BOMM_NGRAM_SOURCE_STRIDED:
+                _bomm_measure_scrambler_sinkov_batch(
+                    n, BOMM_NGRAM_SOURCE_STRIDED, scrambler, plugboards,
+                    batch_size, message, distance, scores);
+                break;
+            default:
+                _bomm_measure_scrambler_sinkov_batch(
+                    n, BOMM_NGRAM_SOURCE_MAP, scrambler, plugboards,
+                    batch_size, message, distance, scores);
+                break;
+        }
+        for (unsigned int c = 0; c < batch_size; c++) {
+            scores[c] = bomm_ngram_score(n, source, scores[c], num_windows);
+        }
+        plugboards += batch_size;
+        scores += batch_size;
+        num_plugboards -= batch_size;
+    }
+}
+
+double bomm_measure_scrambler_trie(
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message
+) {
+    const bomm_measure_trie_config_t* config = bomm_measure_trie_config;
+    double score = 0;
+    if (config->base_measure != BOMM_MEASURE_NONE) {
+        score = config->base_measure_scrambler(scrambler, plugboard, message);
+    }
+    score += bomm_trie_automaton_measure_scrambler(
+        config->automaton, scrambler, plugboard, message);
+    return score;
+}
+
+/**
+ * Define a function measuring scramblers specialized on the given measure.
+ */
+#define BOMM_MEASURE_SCRAMBLER_FUNCTION(measure)                              \
+    static double _bomm_measure_scrambler_##measure(                          \
+        bomm_scrambler_t* scrambler,                                          \
+        bomm_plugboard_t* plugboard,                                          \
+        bomm_message_t* message                                               \
+    ) {                                                                       \
+        return bomm_measure_scrambler(                                        \
+            BOMM_MEASURE_##measure, scrambler, plugboard, message);           \
+    }
+
+BOMM_MEASURE_SCRAMBLER_FUNCTION(SINKOV_MONOGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(SINKOV_BIGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(SINKOV_TRIGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(SINKOV_QUADGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(SINKOV_PENTAGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(SINKOV_HEXAGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(IC)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(IC_BIGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(IC_TRIGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(IC_QUADGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(IC_PENTAGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(IC_HEXAGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(ENTROPY)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(ENTROPY_BIGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(ENTROPY_TRIGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(ENTROPY_QUADGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(ENTROPY_PENTAGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(ENTROPY_HEXAGRAM)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(TRIE)
+BOMM_MEASURE_SCRAMBLER_FUNCTION(NONE)
+
+#undef BOMM_MEASURE_SCRAMBLER_FUNCTION
+
+/**
+ * Lookup table mapping measure values to specialized functions
+ */
+static const struct {
+    bomm_measure_t measure;
+    bomm_measure_scrambler_function_t function;
+} _bomm_measure_scrambler_function_map[] = {
+    { BOMM_MEASURE_SINKOV_MONOGRAM,   _bomm_measure_scrambler_SINKOV_MONOGRAM },
+    { BOMM_MEASURE_SINKOV_BIGRAM,     _bomm_measure_scrambler_SINKOV_BIGRAM },
+    { BOMM_MEASURE_SINKOV_TRIGRAM,    _bomm_measure_scrambler_SINKOV_TRIGRAM },
+    { BOMM_MEASURE_SINKOV_QUADGRAM,   _bomm_measure_scrambler_SINKOV_QUADGRAM },
+    { BOMM_MEASURE_SINKOV_PENTAGRAM,  _bomm_measure_scrambler_SINKOV_PENTAGRAM },
+    { BOMM_MEASURE_SINKOV_HEXAGRAM,   _bomm_measure_scrambler_SINKOV_HEXAGRAM },
+    { BOMM_MEASURE_IC,                _bomm_measure_scrambler_IC },
+    { BOMM_MEASURE_IC_BIGRAM,         _bomm_measure_scrambler_IC_BIGRAM },
+    { BOMM_MEASURE_IC_TRIGRAM,        _bomm_measure_scrambler_IC_TRIGRAM },
+    { BOMM_MEASURE_IC_QUADGRAM,       _bomm_measure_scrambler_IC_QUADGRAM },
+    { BOMM_MEASURE_IC_PENTAGRAM,      _bomm_measure_scrambler_IC_PENTAGRAM },
+    { BOMM_MEASURE_IC_HEXAGRAM,       _bomm_measure_scrambler_IC_HEXAGRAM },
+    { BOMM_MEASURE_ENTROPY,           _bomm_measure_scrambler_ENTROPY },
+    { BOMM_MEASURE_ENTROPY_BIGRAM,    _bomm_measure_scrambler_ENTROPY_BIGRAM },
+    { BOMM_MEASURE_ENTROPY_TRIGRAM,   _bomm_measure_scrambler_ENTROPY_TRIGRAM },
+    { BOMM_MEASURE_ENTROPY_QUADGRAM,  _bomm_measure_scrambler_ENTROPY_QUADGRAM },
+    { BOMM_MEASURE_ENTROPY_PENTAGRAM, _bomm_measure_scrambler_ENTROPY_PENTAGRAM },
+    { BOMM_MEASURE_ENTROPY_HEXAGRAM,  _bomm_measure_scrambler_ENTROPY_HEXAGRAM },
+    { BOMM_MEASURE_TRIE,              _bomm_measure_scrambler_TRIE },
+    { BOMM_MEASURE_NONE,              _bomm_measure_scrambler_NONE }
+};
+
+bomm_measure_scrambler_function_t bomm_measure_scrambler_function(
+    bomm_measure_t measure
+) {
+    // Prefer the vectorized kernels of the selected instruction set extension
+    bomm_simd_t simd = bomm_simd_selected();
+    if (simd != BOMM_SIMD_NONE) {
+        bomm_measure_scrambler_function_t function =
+            bomm_simd_measure_scrambler_function(measure, simd);
+        if (function != NULL) {
+            return function;
+        }
+    }
+
+    unsigned int num_mappings =
+        sizeof(_bomm_measure_scrambler_function_map) /
+        sizeof(_bomm_measure_scrambler_function_map[0]);
+    for (unsigned int i = 0; i < num_mappings; i++) {
+        if (_bomm_measure_scrambler_function_map[i].measure == measure) {
+            return _bomm_measure_scrambler_function_map[i].function;
+        }
+    }
+    return _bomm_measure_scrambler_NONE;
+}
+
+/**
+ * Bounded variant of `_bomm_measure_scrambler_sinkov_sum` returning
+ * `BOMM_MEASURE_ABORTED` as soon as the sum can no longer exceed the given
+ * bound, even if every remaining window took the largest n-gram value.
+ * @param source Passed as a constant to specialize the function
+ */
+static inline __attribute__((always_inline)) double
+_bomm_measure_scrambler_sinkov_bounded_sum(
+    unsigned int n,
+    bomm_ngram_source_t source,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message,
+    double bound_sum
+) {
+    const void* data = bomm_ngram_source_data(n, source);
+    double max_value = bomm_ngram_max_value(n, source);
+    unsigned int length = message->length;
+    unsigned int index, letter;
+
+    double sum = 0;
+    unsigned int map_index = 0;
+
+    for (index = 0; index < length; index++) {
+        letter = message->letters[index];
+        letter = plugboard->map[letter];
+        letter = scrambler->map[index][letter];
+        letter = plugboard->map[letter];
+
+        map_index = bomm_ngram_roll(n, source, map_index, letter);
+
+        if (index >= n - 1) {
+            sum += bomm_ngram_value(source, data, map_index);
+            if (sum + (double) (length - index - 1) * max_value <= bound_sum) {
+                return BOMM_MEASURE_ABORTED;
+            }
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * Bounded variant of `bomm_measure_scrambler_sinkov`.
+ * @param n The n in n-gram
+ */
+static inline __attribute__((always_inline)) double
+_bomm_measure_scrambler_sinkov_bounded(
+    unsigned int n,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message,
+    double bound
+) {
+    bomm_ngram_source_t source = bomm_ngram_source(n);
+    unsigned int num_windows = message->length - n + 1;
+    double bound_sum = bomm_ngram_sum_bound(n, source, bound, num_windows);
+    double sum;
+    switch (source) {
+        case BOMM_NGRAM_SOURCE_LEVELS8:
+            sum = _bomm_measure_scrambler_sinkov_bounded_sum(
+                n, BOMM_NGRAM_SOURCE_LEVELS8, scrambler, plugboard, message,
+                bound_sum);
+            break;
+        case BOMM_NGRAM_SOURCE_LEVELS16:
+            sum = _bomm_measure_scrambler_sinkov_bounded_sum(
+                n, BOMM_NGRAM_SOURCE_LEVELS16, scrambler, plugboard, message,
+                bound_sum);
+            break;
+        case BOMM_NGRAM_SOURCE_SPARSE:
+            sum = _bomm_measure_scrambler_sinkov_bounded_sum(
+                n, BOMM_NGRAM_SOURCE_SPARSE, scrambler, plugboard, message,
+                bound_sum);
+            break;
+        case BOMM_NGRAM_SOURCE_STRIDED:
+            sum = _bomm_measure_scrambler_sinkov_bounded_sum(
+                n, BOMM_NGRAM_SOURCE_STRIDED, scrambler, plugboard, message,
+                bound_sum);
+            break;
+        default:
+            sum = _bomm_measure_scrambler_sinkov_bounded_sum(
+                n, BOMM_NGRAM_SOURCE_MAP, scrambler, plugboard, message,
+                bound_sum);
+            break;
+    }
+    if (sum == BOMM_MEASURE_ABORTED) {
+        return BOMM_MEASURE_ABORTED;
+    }
+    return bomm_ngram_score(n, source, sum, num_windows);
+}
+
+/**
+ * Define a bounded function measuring scramblers specialized on the given
+ * Sinkov measure.
+ */
+#define BOMM_MEASURE_SCRAMBLER_BOUNDED_FUNCTION(measure)                      \
+    static double _bomm_measure_scrambler_bounded_##measure(                  \
+        bomm_scrambler_t* scrambler,                                          \
+        bomm_plugboard_t* plugboard,                                          \
+        bomm_message_t* message,                                              \
+        double bound                                                          \
+    ) {                                                                       \
+        return _bomm_measure_scrambler_sinkov_bounded(                        \
+            BOMM_MEASURE_##measure, scrambler, plugboard, message, bound);    \
+    }
+
+BOMM_MEASURE_SCRAMBLER_BOUNDED_FUNCTION(SINKOV_MONOGRAM)
+BOMM_MEASURE_SCRAMBLER_BOUNDED_FUNCTION(SINKOV_BIGRAM)
+BOMM_MEASURE_SCRAMBLER_BOUNDED_FUNCTION(SINKOV_TRIGRAM)
+BOMM_MEASURE_SCRAMBLER_BOUNDED_FUNCTION(SINKOV_QUADGRAM)
+BOMM_MEASURE_SCRAMBLER_BOUNDED_FUNCTION(SINKOV_PENTAGRAM)
+BOMM_MEASURE_SCRAMBLER_BOUNDED_FUNCTION(SINKOV_HEXAGRAM)
+
+#undef BOMM_MEASURE_SCRAMBLER_BOUNDED_FUNCTION
+
+/**
+ * Bounded function measuring scramblers with the trie measure. The base
+ * measure is taken in full, the trie part is bounded.
+ */
+static double _bomm_measure_scrambler_bounded_TRIE(
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message,
+    double bound
+) {
+    const bomm_measure_trie_config_t* config = bomm_measure_trie_config;
+    if (config == NULL) {
+        return 0;
+    }
+
+    double score = 0;
+    if (config->base_measure != BOMM_MEASURE_NONE) {
+        score = config->base_measure_scrambler(scrambler, plugboard, message);
+    }
+    double trie_score = bomm_trie_automaton_measure_scrambler_bounded(
+        config->automaton,
+        scrambler,
+        plugboard,
+        message,
+        bomm_measure_bound_relax(bound) - score
+    );
+    return trie_score == -INFINITY ? BOMM_MEASURE_ABORTED : score + trie_score;
+}
+
+bomm_measure_scrambler_bounded_function_t bomm_measure_scrambler_bounded_function(
+    bomm_measure_t measure
+) {
+    switch (measure) {
+        case BOMM_MEASURE_SINKOV_MONOGRAM:
+            return _bomm_measure_scrambler_bounded_SINKOV_MONOGRAM;
+        case BOMM_MEASURE_SINKOV_BIGRAM:
+            return _bomm_measure_scrambler_bounded_SINKOV_BIGRAM;
+        case BOMM_MEASURE_SINKOV_TRIGRAM:
+            return _bomm_measure_scrambler_bounded_SINKOV_TRIGRAM;
+        case BOMM_MEASURE_SINKOV_QUADGRAM:
+            return _bomm_measure_scrambler_bounded_SINKOV_QUADGRAM;
+        case BOMM_MEASURE_SINKOV_PENTAGRAM:
+            return _bomm_measure_scrambler_bounded_SINKOV_PENTAGRAM;
+        case BOMM_MEASURE_SINKOV_HEXAGRAM:
+            return _bomm_measure_scrambler_bounded_SINKOV_HEXAGRAM;
+        case BOMM_MEASURE_TRIE:
+            return _bomm_measure_scrambler_bounded_TRIE;
+        default:
+            return NULL;
+    }
+}
+
 void bomm_measure_config_destroy(void) {
     // Frequency n-gram maps
     unsigned int num_ngram_maps =
         sizeof(bomm_ngram_map) / sizeof(bomm_ngram_map[0]);
     for (unsigned int i = 0; i < num_ngram_maps; i++) {
-        if (bomm_ngram_map[i] != NULL) {
-            free(bomm_ngram_map[i]);
-            bomm_ngram_map[i] = NULL;
-        }
+        _bomm_measure_ngram_map_release(i);
     }
 
     // Trie measure config
     if (bomm_measure_trie_config != NULL) {
         bomm_trie_destroy(bomm_measure_trie_config->trie);
         free(bomm_measure_trie_config->trie);
+        free(bomm_measure_trie_config->automaton);
         free(bomm_measure_trie_config);
+        bomm_measure_trie_config = NULL;
     }
 }
@@ -9,7 +9,9 @@
 #define measure_h
 
 #include <jansson.h>
+#include <stdint.h>
 #include "message.h"
+#include "sparse.h"
 #include "wiring.h"
 #include "trie.h"
 
@@ -78,24 +80,239 @@ typedef struct _bomm_ngram_map {
      */
     unsigned char n;
 
+    /**
+     * Log probability assigned to n-grams not listed in the source file
+     */
+    bomm_ngram_map_entry fallback;
+
     /**
      * Maps n-grams to their respective log probabilities
      */
     bomm_ngram_map_entry map[];
 } bomm_ngram_map_t;
 
+/**
+ * Magic bytes identifying n-gram map files in the binary model format
+ */
+#define BOMM_NGRAM_MAP_MAGIC "BOMMNGRM"
+
+/**
+ * Version of the binary model format
+ */
+#define BOMM_NGRAM_MAP_VERSION 3
+
+/**
+ * Header of an n-gram map file in the binary model format. The header is
+ * followed by the `bomm_ngram_map_t` struct as laid out in memory and, for
+ * `n <= BOMM_NGRAM_STRIDED_MAX_N`, by the strided map aligned to cache lines
+ * (see `bomm_ngram_strided`), such that the file can be mapped read-only and
+ * used in place without parsing. Files are only portable between builds
+ * sharing the alphabet and the entry type.
+ */
+typedef struct _bomm_ngram_map_header {
+    /**
+     * Magic bytes `BOMM_NGRAM_MAP_MAGIC` (without the null terminator)
+     */
+    char magic[8];
+
+    /**
+     * Format version `BOMM_NGRAM_MAP_VERSION`
+     */
+    uint32_t version;
+
+    /**
+     * The n in n-gram
+     */
+    uint32_t n;
+
+    /**
+     * Size of a single map entry in bytes
+     */
+    uint32_t entry_size;
+
+    /**
+     * Number of index bits per letter of the strided map following the dense
+     * map or 0, if the file contains no strided map
+     */
+    uint32_t stride_bits;
+
+    /**
+     * Log probability assigned to n-grams not listed in the source file
+     */
+    double fallback;
+
+    /**
+     * Largest log probability of the map (see `bomm_ngram_max`)
+     */
+    double max;
+
+    /**
+     * Fingerprint of the maps following the header; Only verified on request
+     * (see `bomm_measure_ngram_map_verify`), as hashing the map touches every
+     * page of it
+     */
+    uint64_t checksum;
+
+    /**
+     * Null-terminated alphabet the map has been built for
+     */
+    char alphabet[64];
+} bomm_ngram_map_header_t;
+
+/**
+ * Maximum number of candidates visited interleaved by
+ * `bomm_measure_scrambler_sinkov_batch`; Larger batches are split up
+ */
+#define BOMM_MEASURE_MAX_BATCH_SIZE 8
+
 /**
  * Global variable storing pointers to n-gram maps that have been initialized
  * previously. The array index specifies the n in n-gram.
  */
 extern bomm_ngram_map_t* bomm_ngram_map[7];
 
+/**
+ * Enum identifying the number of bits n-gram log probabilities are quantized to
+ */
+typedef enum {
+    BOMM_NGRAM_QUANTIZATION_NONE  = 0,
+    BOMM_NGRAM_QUANTIZATION_INT8  = 8,
+    BOMM_NGRAM_QUANTIZATION_INT16 = 16
+} bomm_ngram_quantization_t;
+
+/**
+ * Variable-size struct representing an n-gram map with log probabilities
+ * quantized to 8 or 16 bit levels. Level `l` represents the log probability
+ * `offset + l * scale`, such that Sinkov scores can be accumulated as integers
+ * and only need to be scaled once per message.
+ */
+typedef struct _bomm_ngram_qmap {
+    /**
+     * The n in n-gram
+     */
+    unsigned char n;
+
+    /**
+     * Number of bits per level
+     */
+    bomm_ngram_quantization_t quantization;
+
+    /**
+     * Log probability represented by level 0
+     */
+    double offset;
+
+    /**
+     * Log probability difference between two adjacent levels
+     */
+    double scale;
+
+    /**
+     * Maximum and mean absolute error over all n-grams against the float map
+     * the levels have been derived from
+     */
+    double max_error;
+    double mean_error;
+
+    /**
+     * Levels of type `uint8_t` or `uint16_t` depending on the quantization
+     */
+    uint64_t levels[];
+} bomm_ngram_qmap_t;
+
+/**
+ * Global variable storing pointers to quantized n-gram maps. If set for an n,
+ * Sinkov measures use them in place of the float maps stored in
+ * `bomm_ngram_map`. The array index specifies the n in n-gram.
+ */
+extern bomm_ngram_qmap_t* bomm_ngram_qmap[7];
+
+/**
+ * Minimum n in n-gram for which frequency files in the text format are loaded
+ * into a sparse map, as the dense maps mostly store the fallback value
+ */
+#define BOMM_NGRAM_SPARSE_MIN_N 5
+
+/**
+ * Global variable storing pointers to sparse n-gram maps. A sparse map takes
+ * the place of the dense map in `bomm_ngram_map` for an n. The array index
+ * specifies the n in n-gram.
+ */
+extern bomm_sparse_t* bomm_ngram_sparse[7];
+
+/**
+ * Number of index bits per letter in the strided n-gram map layout
+ */
+#define BOMM_NGRAM_STRIDE_BITS 5
+
+/**
+ * Maximum n in n-gram for which dense maps are additionally laid out strided;
+ * Bounds the padding overhead (`32^n` instead of `26^n` entries)
+ */
+#define BOMM_NGRAM_STRIDED_MAX_N 4
+
+/**
+ * Global variable storing pointers to dense n-gram maps laid out with a stride
+ * of `2^BOMM_NGRAM_STRIDE_BITS` entries per letter, such that rolling the
+ * n-gram index takes a shift, an or, and a mask rather than a modulo. Built by
+ * the loader for `n <= BOMM_NGRAM_STRIDED_MAX_N`, if the alphabet fits the
+ * stride, or mapped along with a file in the binary model format. Padding
+ * entries hold the fallback value. The array index specifies the n in n-gram.
+ */
+extern bomm_ngram_map_entry* bomm_ngram_strided[7];
+
+/**
+ * Global variable storing the largest log probability of the n-gram map
+ * (dense or sparse) loaded for each n, i.e. the most a single window may
+ * contribute to a Sinkov sum, or `INFINITY`, if no map is loaded. The array
+ * index specifies the n in n-gram.
+ */
+extern double bomm_ngram_max[7];
+
+/**
+ * Enum identifying the representation Sinkov measures look up n-gram values in
+ */
+typedef enum {
+    BOMM_NGRAM_SOURCE_MAP,
+    BOMM_NGRAM_SOURCE_STRIDED,
+    BOMM_NGRAM_SOURCE_LEVELS8,
+    BOMM_NGRAM_SOURCE_LEVELS16,
+    BOMM_NGRAM_SOURCE_SPARSE
+} bomm_ngram_source_t;
+
+/**
+ * Return the mask of the strided n-gram index for the given n.
+ */
+static inline unsigned int bomm_ngram_strided_mask(unsigned int n) {
+    return (1u << (BOMM_NGRAM_STRIDE_BITS * n)) - 1;
+}
+
+/**
+ * Function measuring a message put through the given scrambler and plugboard
+ * using a measure it has been specialized for.
+ */
+typedef double (*bomm_measure_scrambler_function_t)(
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message
+);
+
 /**
  * Set of configuration options for the trie measure.
  */
 typedef struct _bomm_measure_trie_config {
     bomm_trie_t* trie;
     bomm_measure_t base_measure;
+
+    /**
+     * Function measuring the base measure; Resolved once along with the config
+     */
+    bomm_measure_scrambler_function_t base_measure_scrambler;
+
+    /**
+     * Automaton compiled from the trie the measure is evaluated with
+     */
+    bomm_trie_automaton_t* automaton;
 } bomm_measure_trie_config_t;
 
 /**
@@ -111,35 +328,318 @@ extern const unsigned int bomm_pow_map[7];
 
 /**
  * Allocate an n-gram frequency map in memory and fill it with the contents
- * parsed from the given file.
- * Stores the pointer to the global variable `bomm_ngram_map[n]`.
+ * parsed from the given file. Files in the binary model format (see
+ * `bomm_ngram_map_header_t`) are mapped read-only instead, sharing their pages
+ * with other processes mapping the same file.
+ * Stores the pointer to the global variable `bomm_ngram_map[n]`, replacing
+ * (and freeing) a map previously stored there.
  */
 bomm_ngram_map_t* bomm_measure_ngram_map_init(
     unsigned char n,
     const char* filename
 );
 
+/**
+ * Build a sparse n-gram map from the n-grams listed in the given frequency file
+ * (text format only). Assigns the same log probabilities as the dense map.
+ * Stores the pointer to the global variable `bomm_ngram_sparse[n]`, replacing
+ * (and freeing) any map previously loaded for this n.
+ */
+bomm_sparse_t* bomm_measure_ngram_sparse_init(
+    unsigned char n,
+    const char* filename
+);
+
+/**
+ * Load the n-gram model for the given n from a file in the way best suited:
+ * Files in the binary model format are mapped, text files are parsed into a
+ * sparse map for `n >= BOMM_NGRAM_SPARSE_MIN_N` and into a dense map otherwise.
+ * @return Returns false on failure.
+ */
+bool bomm_measure_ngram_model_init(unsigned char n, const char* filename);
+
+/**
+ * Write the given n-gram map to a file in the binary model format.
+ * @return Returns true, if the file has been written successfully.
+ */
+bool bomm_measure_ngram_map_save(
+    const bomm_ngram_map_t* ngram_map,
+    const char* filename
+);
+
+/**
+ * Check the fingerprint of the n-gram map file in the binary model format at
+ * the given path against the checksum stored in its header.
+ * @return Returns true, if the file is valid and intact.
+ */
+bool bomm_measure_ngram_map_verify(unsigned char n, const char* filename);
+
+/**
+ * Convert the n-gram frequency file at the source path to the binary model
+ * format, write it to the target path, and verify the file written.
+ * @return Returns true, if the conversion succeeded.
+ */
+bool bomm_measure_ngram_map_convert(
+    unsigned char n,
+    const char* source_filename,
+    const char* target_filename
+);
+
+/**
+ * Quantize the n-gram map stored in `bomm_ngram_map[n]` to the given number of
+ * bits and store the result in `bomm_ngram_qmap[n]`, replacing (and freeing)
+ * a quantized map previously stored there. Passing
+ * `BOMM_NGRAM_QUANTIZATION_NONE` reverts to the float map.
+ * @return Returns false, if the n-gram map is not loaded or on allocation
+ * failure.
+ */
+bool bomm_measure_ngram_qmap_init(
+    unsigned char n,
+    bomm_ngram_quantization_t quantization
+);
+
+/**
+ * Return the log probability represented by the given level.
+ */
+static inline double bomm_ngram_qmap_level_value(
+    const bomm_ngram_qmap_t* qmap,
+    unsigned int level
+) {
+    return qmap->offset + (double) level * qmap->scale;
+}
+
+/**
+ * Turn the sum of levels over the windows of a message into a Sinkov score.
+ */
+static inline double bomm_ngram_qmap_score(
+    const bomm_ngram_qmap_t* qmap,
+    double level_sum,
+    unsigned int num_windows
+) {
+    return qmap->offset + level_sum * qmap->scale / (double) num_windows;
+}
+
 /**
  * Destroy and free global measure config values.
  */
 void bomm_measure_config_destroy(void);
 
 /**
- * Measure the n-gram score of a message put through the given
- * scrabler and plugboard.
- * @param n The n in n-gram
+ * Roll the n-gram index of the given source by another letter.
+ * @param source Passed as a constant to specialize the function
  */
-static inline double bomm_measure_scrambler_sinkov(
+static inline __attribute__((always_inline)) unsigned int bomm_ngram_roll(
+    unsigned int n,
+    bomm_ngram_source_t source,
+    unsigned int map_index,
+    unsigned int letter
+) {
+    if (source == BOMM_NGRAM_SOURCE_STRIDED) {
+        return
+            ((map_index << BOMM_NGRAM_STRIDE_BITS) | letter) &
+            bomm_ngram_strided_mask(n);
+    }
+    // Drop the leading letter before shifting, such that hexagram indices
+    // do not overflow
+    return (map_index % bomm_pow_map[n - 1]) * BOMM_ALPHABET_SIZE + letter;
+}
+
+/**
+ * Return the representation Sinkov measures look up n-gram values in for the
+ * given n.
+ */
+static inline bomm_ngram_source_t bomm_ngram_source(unsigned int n) {
+    const bomm_ngram_qmap_t* qmap = bomm_ngram_qmap[n];
+    if (qmap != NULL) {
+        return qmap->quantization == BOMM_NGRAM_QUANTIZATION_INT8
+            ? BOMM_NGRAM_SOURCE_LEVELS8
+            : BOMM_NGRAM_SOURCE_LEVELS16;
+    }
+    if (bomm_ngram_sparse[n] != NULL) {
+        return BOMM_NGRAM_SOURCE_SPARSE;
+    }
+    return bomm_ngram_strided[n] != NULL
+        ? BOMM_NGRAM_SOURCE_STRIDED
+        : BOMM_NGRAM_SOURCE_MAP;
+}
+
+/**
+ * Return the value an n-gram contributes to the Sinkov sum: Its log
+ * probability or its level, if quantized.
+ * @param source Passed as a constant to specialize the function
+ * @param data Dense map, quantized map, or sparse map matching the source
+ */
+static inline __attribute__((always_inline)) double bomm_ngram_value(
+    bomm_ngram_source_t source,
+    const void* data,
+    unsigned int map_index
+) {
+    switch (source) {
+        case BOMM_NGRAM_SOURCE_LEVELS8:
+            return ((const uint8_t*) ((const bomm_ngram_qmap_t*) data)->levels)[map_index];
+        case BOMM_NGRAM_SOURCE_LEVELS16:
+            return ((const uint16_t*) ((const bomm_ngram_qmap_t*) data)->levels)[map_index];
+        case BOMM_NGRAM_SOURCE_SPARSE:
+            return bomm_sparse_lookup(data, map_index);
+        case BOMM_NGRAM_SOURCE_STRIDED:
+            return ((const bomm_ngram_map_entry*) data)[map_index];
+        default:
+            return ((const bomm_ngram_map_t*) data)->map[map_index];
+    }
+}
+
+/**
+ * Return the map `bomm_ngram_value` expects for the given n and source.
+ */
+static inline const void* bomm_ngram_source_data(
+    unsigned int n,
+    bomm_ngram_source_t source
+) {
+    switch (source) {
+        case BOMM_NGRAM_SOURCE_LEVELS8:
+        case BOMM_NGRAM_SOURCE_LEVELS16:
+            return bomm_ngram_qmap[n];
+        case BOMM_NGRAM_SOURCE_SPARSE:
+            return bomm_ngram_sparse[n];
+        case BOMM_NGRAM_SOURCE_STRIDED:
+            return bomm_ngram_strided[n];
+        default:
+            return bomm_ngram_map[n];
+    }
+}
+
+/**
+ * Return the largest value an n-gram may contribute to the Sinkov sum in the
+ * given source.
+ */
+static inline double bomm_ngram_max_value(
+    unsigned int n,
+    bomm_ngram_source_t source
+) {
+    if (
+        source == BOMM_NGRAM_SOURCE_LEVELS8 ||
+        source == BOMM_NGRAM_SOURCE_LEVELS16
+    ) {
+        // The largest log probability is mapped to the top level
+        const bomm_ngram_qmap_t* qmap = bomm_ngram_qmap[n];
+        return qmap->scale > 0 ? (double) ((1u << qmap->quantization) - 1) : 0;
+    }
+    return bomm_ngram_max[n];
+}
+
+/**
+ * Prefetch the cache line holding (or, for sparse maps, guarding) the value of
+ * the given n-gram.
+ * @param source Passed as a constant to specialize the function
+ */
+static inline __attribute__((always_inline)) void bomm_ngram_prefetch(
+    bomm_ngram_source_t source,
+    const void* data,
+    unsigned int map_index
+) {
+    switch (source) {
+        case BOMM_NGRAM_SOURCE_LEVELS8:
+            __builtin_prefetch(&((const uint8_t*) ((const bomm_ngram_qmap_t*) data)->levels)[map_index]);
+            break;
+        case BOMM_NGRAM_SOURCE_LEVELS16:
+            __builtin_prefetch(&((const uint16_t*) ((const bomm_ngram_qmap_t*) data)->levels)[map_index]);
+            break;
+        case BOMM_NGRAM_SOURCE_SPARSE: {
+            const bomm_sparse_t* sparse = data;
+            __builtin_prefetch(&sparse->bloom[
+                bomm_sparse_bloom_hash(map_index) & sparse->bloom_mask]);
+            break;
+        }
+        case BOMM_NGRAM_SOURCE_STRIDED:
+            __builtin_prefetch(&((const bomm_ngram_map_entry*) data)[map_index]);
+            break;
+        default:
+            __builtin_prefetch(&((const bomm_ngram_map_t*) data)->map[map_index]);
+            break;
+    }
+}
+
+/**
+ * Turn the sum of n-gram values over the windows of a message into a Sinkov
+ * score.
+ */
+static inline double bomm_ngram_score(
+    unsigned int n,
+    bomm_ngram_source_t source,
+    double sum,
+    unsigned int num_windows
+) {
+    if (
+        source == BOMM_NGRAM_SOURCE_LEVELS8 ||
+        source == BOMM_NGRAM_SOURCE_LEVELS16
+    ) {
+        return bomm_ngram_qmap_score(bomm_ngram_qmap[n], sum, num_windows);
+    }
+    return sum / (double) num_windows;
+}
+
+/**
+ * Score returned by bounded measurements that have been aborted, as the score
+ * could no longer exceed the given bound
+ */
+#define BOMM_MEASURE_ABORTED (-INFINITY)
+
+/**
+ * Relative tolerance bounded measurements give away to the bound, such that
+ * rounding never aborts a measurement that would exceed it
+ */
+#define BOMM_MEASURE_BOUND_TOLERANCE 1e-9
+
+/**
+ * Loosen the given bound by the tolerance of bounded measurements.
+ */
+static inline double bomm_measure_bound_relax(double bound) {
+    return bound - (fabs(bound) + 1) * BOMM_MEASURE_BOUND_TOLERANCE;
+}
+
+/**
+ * Turn a Sinkov score bound into the (relaxed) bound of the sum of n-gram
+ * values over the windows of a message, i.e. invert `bomm_ngram_score`.
+ */
+static inline double bomm_ngram_sum_bound(
     unsigned int n,
+    bomm_ngram_source_t source,
+    double bound,
+    unsigned int num_windows
+) {
+    double sum;
+    if (
+        source == BOMM_NGRAM_SOURCE_LEVELS8 ||
+        source == BOMM_NGRAM_SOURCE_LEVELS16
+    ) {
+        const bomm_ngram_qmap_t* qmap = bomm_ngram_qmap[n];
+        if (qmap->scale <= 0) {
+            return -INFINITY;
+        }
+        sum = (bound - qmap->offset) * (double) num_windows / qmap->scale;
+    } else {
+        sum = bound * (double) num_windows;
+    }
+    return bomm_measure_bound_relax(sum);
+}
+
+/**
+ * Sum up the n-gram values of a message put through the given scrambler and
+ * plugboard.
+ * @param source Passed as a constant to specialize the function
+ */
+static inline __attribute__((always_inline)) double
+_bomm_measure_scrambler_sinkov_sum(
+    unsigned int n,
+    bomm_ngram_source_t source,
     bomm_scrambler_t* scrambler,
     bomm_plugboard_t* plugboard,
     bomm_message_t* message
 ) {
-    unsigned int map_size = bomm_pow_map[n];
-    const bomm_ngram_map_t* map = bomm_ngram_map[n];
+    const void* data = bomm_ngram_source_data(n, source);
     unsigned int index, letter;
 
-    double score = 0;
+    double sum = 0;
     unsigned int map_index = 0;
 
     for (index = 0; index < message->length; index++) {
@@ -148,14 +648,73 @@ static inline double bomm_measure_scrambler_sinkov(
         letter = scrambler->map[index][letter];
         letter = plugboard->map[letter];
 
-        map_index = (map_index * BOMM_ALPHABET_SIZE + letter) % map_size;
+        map_index = bomm_ngram_roll(n, source, map_index, letter);
 
         if (index >= n - 1) {
-            score += map->map[map_index];
+            sum += bomm_ngram_value(source, data, map_index);
         }
     }
 
-    return score / (double) (message->length - n + 1);
+    return sum;
+}
+
+/**
+ * Measure the n-gram scores of a message put through the given scrambler and
+ * each of the given plugboards. Computes the n-gram indices of all candidates
+ * first and then visits them interleaved, prefetching the values `distance`
+ * windows ahead, such that many cache misses are outstanding at once. Scores
+ * match `bomm_measure_scrambler_sinkov` exactly. Messages shorter than n have
+ * no windows and score 0.
+ * @param n The n in n-gram
+ * @param distance Prefetch distance in windows or 0 to disable prefetching
+ * @param scores Array receiving a score per plugboard
+ */
+void bomm_measure_scrambler_sinkov_batch(
+    unsigned int n,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* const* plugboards,
+    unsigned int num_plugboards,
+    bomm_message_t* message,
+    unsigned int distance,
+    double* scores
+);
+
+/**
+ * Measure the n-gram score of a message put through the given
+ * scrabler and plugboard.
+ * @param n The n in n-gram
+ */
+static inline double bomm_measure_scrambler_sinkov(
+    unsigned int n,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message
+) {
+    bomm_ngram_source_t source = bomm_ngram_source(n);
+    double sum;
+    switch (source) {
+        case BOMM_NGRAM_SOURCE_LEVELS8:
+            sum = _bomm_measure_scrambler_sinkov_sum(
+                n, BOMM_NGRAM_SOURCE_LEVELS8, scrambler, plugboard, message);
+            break;
+        case BOMM_NGRAM_SOURCE_LEVELS16:
+            sum = _bomm_measure_scrambler_sinkov_sum(
+                n, BOMM_NGRAM_SOURCE_LEVELS16, scrambler, plugboard, message);
+            break;
+        case BOMM_NGRAM_SOURCE_SPARSE:
+            sum = _bomm_measure_scrambler_sinkov_sum(
+                n, BOMM_NGRAM_SOURCE_SPARSE, scrambler, plugboard, message);
+            break;
+        case BOMM_NGRAM_SOURCE_STRIDED:
+            sum = _bomm_measure_scrambler_sinkov_sum(
+                n, BOMM_NGRAM_SOURCE_STRIDED, scrambler, plugboard, message);
+            break;
+        default:
+            sum = _bomm_measure_scrambler_sinkov_sum(
+                n, BOMM_NGRAM_SOURCE_MAP, scrambler, plugboard, message);
+            break;
+    }
+    return bomm_ngram_score(n, source, sum, message->length - n + 1);
 }
 
 /**
@@ -166,23 +725,25 @@ static inline double bomm_measure_message_sinkov(
     unsigned int n,
     bomm_message_t* message
 ) {
-    unsigned int map_size = bomm_pow_map[n];
-    const bomm_ngram_map_t* map = bomm_ngram_map[n];
+    bomm_ngram_source_t source = bomm_ngram_source(n);
+    const void* data = bomm_ngram_source_data(n, source);
     unsigned int index, letter;
 
-    double score = 0;
+    double sum = 0;
     unsigned int map_index = 0;
 
     for (index = 0; index < message->length; index++) {
         letter = message->letters[index];
-        map_index = (map_index * BOMM_ALPHABET_SIZE + letter) % map_size;
+        map_index = source == BOMM_NGRAM_SOURCE_STRIDED
+            ? bomm_ngram_roll(n, BOMM_NGRAM_SOURCE_STRIDED, map_index, letter)
+            : bomm_ngram_roll(n, BOMM_NGRAM_SOURCE_MAP, map_index, letter);
 
         if (index >= n - 1) {
-            score += map->map[map_index];
+            sum += bomm_ngram_value(source, data, map_index);
         }
     }
 
-    return score / (double) (message->length - n + 1);
+    return bomm_ngram_score(n, source, sum, message->length - n + 1);
 }
 
 /**
@@ -294,6 +855,137 @@ static inline double bomm_measure_frequency_entropy(
     return entropy;
 }
 
+/**
+ * Minimum n in n-gram for which IC and entropy are calculated from a sorted
+ * list of n-grams in `O(L log L)` rather than a histogram of size
+ * `pow(BOMM_ALPHABET_SIZE, n)`, which gets too large to be kept on the stack.
+ */
+#define BOMM_MEASURE_SPARSE_MIN_N 3
+
+/**
+ * Collect the n-gram indices of the message put through the given scrambler
+ * and plugboard.
+ * @param n The n in n-gram
+ * @param ngrams Array of size `message->length`
+ * @return Number of n-grams collected
+ */
+static inline unsigned int bomm_measure_scrambler_ngrams(
+    unsigned int n,
+    unsigned int* ngrams,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message
+) {
+    unsigned int prefix_size = bomm_pow_map[n - 1];
+    unsigned int num_ngrams = 0;
+    unsigned int letter;
+    unsigned int map_index = 0;
+    for (unsigned int index = 0; index < message->length; index++) {
+        letter = message->letters[index];
+        letter = plugboard->map[letter];
+        letter = scrambler->map[index][letter];
+        letter = plugboard->map[letter];
+
+        map_index = (map_index % prefix_size) * BOMM_ALPHABET_SIZE + letter;
+        if (index >= n - 1) {
+            ngrams[num_ngrams++] = map_index;
+        }
+    }
+    return num_ngrams;
+}
+
+/**
+ * Collect the n-gram indices of the given message.
+ * @param n The n in n-gram
+ * @param ngrams Array of size `message->length`
+ * @return Number of n-grams collected
+ */
+static inline unsigned int bomm_measure_message_ngrams(
+    unsigned int n,
+    unsigned int* ngrams,
+    bomm_message_t* message
+) {
+    unsigned int prefix_size = bomm_pow_map[n - 1];
+    unsigned int num_ngrams = 0;
+    unsigned int map_index = 0;
+    for (unsigned int index = 0; index < message->length; index++) {
+        map_index =
+            (map_index % prefix_size) * BOMM_ALPHABET_SIZE +
+            message->letters[index];
+        if (index >= n - 1) {
+            ngrams[num_ngrams++] = map_index;
+        }
+    }
+    return num_ngrams;
+}
+
+/**
+ * Compare two n-gram indices (used to sort n-gram lists).
+ */
+static inline int bomm_measure_ngram_compare(const void* a, const void* b) {
+    unsigned int x = *(const unsigned int*) a;
+    unsigned int y = *(const unsigned int*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Calculate the normalized Index of coincidence (IC) from the given list of
+ * n-grams. Sorts the list in place. Equivalent to `bomm_measure_frequency_ic`.
+ * @param n The n in n-gram
+ */
+static inline double bomm_measure_ngrams_ic(
+    unsigned int n,
+    unsigned int* ngrams,
+    unsigned int num_ngrams
+) {
+    qsort(ngrams, num_ngrams, sizeof(unsigned int), bomm_measure_ngram_compare);
+    unsigned int coincidence = 0;
+    unsigned int frequency;
+    unsigned int index = 0;
+    while (index < num_ngrams) {
+        frequency = 1;
+        while (
+            index + frequency < num_ngrams &&
+            ngrams[index + frequency] == ngrams[index]
+        ) {
+            frequency++;
+        }
+        coincidence += frequency * (frequency - 1);
+        index += frequency;
+    }
+    return
+        (double) bomm_pow_map[n] * (double) coincidence /
+        (double) (num_ngrams * (num_ngrams - 1));
+}
+
+/**
+ * Calculate the Entropy in bits from the given list of n-grams. Sorts the
+ * list in place. Equivalent to `bomm_measure_frequency_entropy`.
+ */
+static inline double bomm_measure_ngrams_entropy(
+    unsigned int* ngrams,
+    unsigned int num_ngrams
+) {
+    qsort(ngrams, num_ngrams, sizeof(unsigned int), bomm_measure_ngram_compare);
+    double entropy = 0;
+    double p;
+    unsigned int frequency;
+    unsigned int index = 0;
+    while (index < num_ngrams) {
+        frequency = 1;
+        while (
+            index + frequency < num_ngrams &&
+            ngrams[index + frequency] == ngrams[index]
+        ) {
+            frequency++;
+        }
+        p = (double) frequency / (double) num_ngrams;
+        entropy -= p * log2(p);
+        index += frequency;
+    }
+    return entropy;
+}
+
 /**
  * Return the measure value from the given string.
  */
@@ -357,11 +1049,23 @@ static inline double bomm_measure_message(
         return bomm_measure_message_sinkov(n, message);
     } else if (measure < 0x20) {
         unsigned int n = measure - 0x10;
+        if (n >= BOMM_MEASURE_SPARSE_MIN_N) {
+            unsigned int ngrams[message->length + 1];
+            unsigned int num_ngrams =
+                bomm_measure_message_ngrams(n, ngrams, message);
+            return bomm_measure_ngrams_ic(n, ngrams, num_ngrams);
+        }
         unsigned int frequencies[bomm_pow_map[n]];
         bomm_measure_message_frequency(n, frequencies, message);
         return bomm_measure_frequency_ic(n, frequencies);
     } else if (measure < 0x30) {
         unsigned int n = measure - 0x20;
+        if (n >= BOMM_MEASURE_SPARSE_MIN_N) {
+            unsigned int ngrams[message->length + 1];
+            unsigned int num_ngrams =
+                bomm_measure_message_ngrams(n, ngrams, message);
+            return bomm_measure_ngrams_entropy(ngrams, num_ngrams);
+        }
         unsigned int frequencies[bomm_pow_map[n]];
         bomm_measure_message_frequency(n, frequencies, message);
         return bomm_measure_frequency_entropy(n, frequencies);
@@ -371,13 +1075,24 @@ static inline double bomm_measure_message(
         if (base_measure != BOMM_MEASURE_NONE) {
             score = bomm_measure_message(base_measure, message);
         }
-        score += bomm_trie_measure_message(
-            bomm_measure_trie_config->trie, message);
+        score += bomm_trie_automaton_measure_message(
+            bomm_measure_trie_config->automaton, message);
         return score;
     }
     return 0;
 }
 
+/**
+ * Measure the trie score of a message put through the given scrambler and
+ * plugboard, including the base measure configured. The trie automaton reads
+ * the scrambler output letters directly without materializing the plaintext.
+ */
+double bomm_measure_scrambler_trie(
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message
+);
+
 /**
  * Measure a message put through the given scrabler and plugboard
  */
@@ -392,31 +1107,65 @@ static inline __attribute__((always_inline)) double bomm_measure_scrambler(
         return bomm_measure_scrambler_sinkov(n, scrambler, plugboard, message);
     } else if (measure < 0x20) {
         unsigned int n = measure - 0x10;
+        if (n >= BOMM_MEASURE_SPARSE_MIN_N) {
+            unsigned int ngrams[message->length + 1];
+            unsigned int num_ngrams = bomm_measure_scrambler_ngrams(
+                n, ngrams, scrambler, plugboard, message);
+            return bomm_measure_ngrams_ic(n, ngrams, num_ngrams);
+        }
         unsigned int frequencies[bomm_pow_map[n]];
         bomm_measure_scrambler_frequency(n, frequencies, scrambler, plugboard, message);
         return bomm_measure_frequency_ic(n, frequencies);
     } else if (measure < 0x30) {
         unsigned int n = measure - 0x20;
+        if (n >= BOMM_MEASURE_SPARSE_MIN_N) {
+            unsigned int ngrams[message->length + 1];
+            unsigned int num_ngrams = bomm_measure_scrambler_ngrams(
+                n, ngrams, scrambler, plugboard, message);
+            return bomm_measure_ngrams_entropy(ngrams, num_ngrams);
+        }
         unsigned int frequencies[bomm_pow_map[n]];
         bomm_measure_scrambler_frequency(n, frequencies, scrambler, plugboard, message);
         return bomm_measure_frequency_entropy(n, frequencies);
     } else if (measure == BOMM_MEASURE_TRIE && bomm_measure_trie_config != NULL) {
-        size_t message_size = bomm_message_size_for_length(message->length);
-        bomm_message_t* plaintext = malloc(message_size);
-        if (plaintext != NULL) {
-            bomm_scrambler_encrypt(scrambler, plugboard, message, plaintext);
-            bomm_measure_t base_measure = bomm_measure_trie_config->base_measure;
-            double score = 0;
-            if (base_measure != BOMM_MEASURE_NONE) {
-                score = bomm_measure_message(base_measure, plaintext);
-            }
-            score += bomm_trie_measure_message(
-                bomm_measure_trie_config->trie, plaintext);
-            free(plaintext);
-            return score;
-        }
+        return bomm_measure_scrambler_trie(scrambler, plugboard, message);
     }
     return 0;
 }
 
+/**
+ * Return the function measuring scramblers with the given measure: The
+ * vectorized kernel of the selected instruction set extension (see
+ * `bomm_simd_selected`), if there is one for the measure, or the scalar
+ * function compiled with the measure (and thus the n in n-gram) being
+ * constant. The function is looked up in tables on every call, so it is
+ * resolved once when a pass or measure config is built and stored there.
+ */
+bomm_measure_scrambler_function_t bomm_measure_scrambler_function(
+    bomm_measure_t measure
+);
+
+/**
+ * Function measuring a message put through the given scrambler and plugboard
+ * that stops as soon as the score can no longer exceed the given bound, even
+ * if the rest of the message scored as high as possible (branch and bound).
+ * Returns `BOMM_MEASURE_ABORTED` in this case and the full score otherwise.
+ */
+typedef double (*bomm_measure_scrambler_bounded_function_t)(
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message,
+    double bound
+);
+
+/**
+ * Return the bounded function specialized for measuring scramblers with the
+ * given measure or NULL, if the measure can't be bounded. Sinkov measures are
+ * bounded by the largest n-gram value per remaining window and the trie
+ * measure by the largest automaton output per remaining letter.
+ */
+bomm_measure_scrambler_bounded_function_t bomm_measure_scrambler_bounded_function(
+    bomm_measure_t measure
+);
+
 #endif /* measure_h */
@@ -20,6 +20,15 @@
  */
 typedef unsigned char bomm_letter_t;
 
+/**
+ * Swap the letters at the given pointers.
+ */
+static inline void bomm_swap_letter(bomm_letter_t* a, bomm_letter_t* b) {
+    bomm_letter_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
 /**
  * Variable-size struct storing an Enigma message. It consists of an arbitrary
  * number of letter indices.
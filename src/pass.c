@@ -13,6 +13,8 @@ bomm_pass_t* bomm_pass_init(bomm_pass_t* pass) {
     }
     pass->type = BOMM_PASS_MEASURE;
     pass->config.measure.measure = BOMM_MEASURE_IC;
+    pass->config.measure.measure_scrambler =
+        bomm_measure_scrambler_function(BOMM_MEASURE_IC);
     return pass;
 }
 
@@ -66,6 +66,10 @@ typedef struct _bomm_pass {
 
 /**
  * Run a pass on the given plugboard and scrambler
+ * @param scratch Scratch buffers of the attack or NULL
+ * @param num_decrypts Counter of the measurements taken
+ * @param num_aborts Counter of the measurements aborted early (see
+ * `bomm_measure_scrambler_bounded_function_t`)
  */
 inline static double bomm_pass_run(
     bomm_pass_t* pass,
@@ -73,7 +77,9 @@ inline static double bomm_pass_run(
     bomm_scrambler_t* scrambler,
     bomm_message_t* ciphertext,
     double score,
-    unsigned int* num_decrypts
+    bomm_scratch_t* scratch,
+    unsigned int* num_decrypts,
+    unsigned int* num_aborts
 ) {
     switch (pass->type) {
         case BOMM_PASS_HILL_CLIMB: {
@@ -82,7 +88,9 @@ inline static double bomm_pass_run(
                 plugboard,
                 scrambler,
                 ciphertext,
-                num_decrypts
+                scratch,
+                num_decrypts,
+                num_aborts
             );
         }
         case BOMM_PASS_RESWAPPING: {
@@ -91,7 +99,9 @@ inline static double bomm_pass_run(
                 plugboard,
                 scrambler,
                 ciphertext,
-                num_decrypts
+                scratch,
+                num_decrypts,
+                num_aborts
             );
         }
         case BOMM_PASS_TRIE: {
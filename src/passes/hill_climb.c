@@ -6,6 +6,7 @@
 //
 
 #include "hill_climb.h"
+#include "../delta.h"
 #include "../utility.h"
 
 double bomm_pass_hill_climb_run(
@@ -13,7 +14,9 @@ double bomm_pass_hill_climb_run(
     bomm_plugboard_t* plugboard,
     bomm_scrambler_t* scrambler,
     bomm_message_t* ciphertext,
-    unsigned int* num_decrypts
+    bomm_scratch_t* scratch,
+    unsigned int* num_decrypts,
+    unsigned int* num_aborts
 ) {
     // Action values encode swap operations that can be applied to a set of
     // 4 plugs (the chosen pair and up to two letters that may be connected to
@@ -106,7 +109,7 @@ double bomm_pass_hill_climb_run(
     const unsigned char* actions_begin;
 
     // Set of plugs and set of actions needed to recreate the best result
-    unsigned int* best_plugs[4];
+    bomm_letter_t* best_plugs[4];
     const unsigned char* best_actions_begin;
     const unsigned char* best_actions_end;
 
@@ -117,6 +120,19 @@ double bomm_pass_hill_climb_run(
     unsigned int backtracking_min_num_plugs = config->backtracking_min_num_plugs;
     bomm_measure_t measure = config->measure;
     bomm_measure_t last_measure = BOMM_MEASURE_NONE;
+    bomm_measure_scrambler_function_t measure_scrambler = NULL;
+    bomm_measure_scrambler_bounded_function_t measure_scrambler_bounded = NULL;
+
+    // Sinkov measures with a loaded n-gram map as well as IC and entropy
+    // measures up to bigrams are evaluated incrementally (see `bomm_delta_t`)
+    bomm_delta_t* delta = NULL;
+    bool delta_active = false;
+    if (
+        bomm_delta_supports(config->measure) ||
+        bomm_delta_supports(config->final_measure)
+    ) {
+        delta = bomm_scratch_delta(scratch, ciphertext->length);
+    }
 
     bool found_improvement = true;
     while (found_improvement) {
@@ -131,13 +147,19 @@ double bomm_pass_hill_climb_run(
         // Take an initial measurement, if the measure changes
         if (measure != last_measure) {
             last_measure = measure;
+            if (measure == config->final_measure) {
+                measure_scrambler = config->final_measure_scrambler;
+                measure_scrambler_bounded = config->final_measure_scrambler_bounded;
+            } else {
+                measure_scrambler = config->measure_scrambler;
+                measure_scrambler_bounded = config->measure_scrambler_bounded;
+            }
             (*num_decrypts)++;
-            best_score = bomm_measure_scrambler(
-                measure,
-                scrambler,
-                plugboard,
-                ciphertext
-            );
+            delta_active = delta != NULL && bomm_delta_init(
+                delta, measure, scrambler, plugboard, ciphertext) != NULL;
+            best_score = delta_active
+                ? bomm_delta_score(delta)
+                : measure_scrambler(scrambler, plugboard, ciphertext);
         }
 
         // Enumerate all possible plugboard pairs
@@ -151,7 +173,7 @@ double bomm_pass_hill_climb_run(
                 // SullivanWeierud2005, 198.
 
                 // Selected plugs 4-tuple (`i` partner, `i`, `k`, `k` partner)
-                unsigned int* plugs[4] = {
+                bomm_letter_t* plugs[4] = {
                     &plugboard->map[plugboard->map[i]],
                     &plugboard->map[i],
                     &plugboard->map[k],
@@ -186,20 +208,27 @@ double bomm_pass_hill_climb_run(
                 for (action = actions_begin; *action != 0x00; action++) {
                     // The two least significant bits signify the first plug
                     // and the next two bits the second plug to be swapped
-                    bomm_swap(plugs[*action & 0x3], plugs[(*action >> 2) & 0x3]);
+                    bomm_swap_letter(plugs[*action & 0x3], plugs[(*action >> 2) & 0x3]);
                     num_plugs += (*action & 0x20) == 0x20 ? -1 : (*action >> 4);
 
                     if (*action == 0x0f) {
-                        // Take a measurement and compare it
+                        // Take a measurement and compare it; Most candidates
+                        // don't beat the best score, thus full measurements
+                        // stop as soon as they can no longer do so
                         (*num_decrypts)++;
-                        score = bomm_measure_scrambler(
-                            measure,
-                            scrambler,
-                            plugboard,
-                            ciphertext
-                        );
-
-                        if (score > best_score) {
+                        if (delta_active) {
+                            score = bomm_delta_measure(delta, plugboard);
+                        } else if (measure_scrambler_bounded != NULL) {
+                            score = measure_scrambler_bounded(
+                                scrambler, plugboard, ciphertext, best_score);
+                        } else {
+                            score = measure_scrambler(
+                                scrambler, plugboard, ciphertext);
+                        }
+
+                        if (score == BOMM_MEASURE_ABORTED) {
+                            (*num_aborts)++;
+                        } else if (score > best_score) {
                             best_score = score;
                             found_improvement = true;
 
@@ -216,14 +245,21 @@ double bomm_pass_hill_climb_run(
         if (best_actions_end != NULL) {
             // Choose the best performing result for all pairs
             for (action = best_actions_begin; action < best_actions_end; action++) {
-                bomm_swap(best_plugs[*action & 0x3], best_plugs[(*action >> 2) & 0x3]);
+                bomm_swap_letter(best_plugs[*action & 0x3], best_plugs[(*action >> 2) & 0x3]);
                 num_plugs += (*action & 0x20) == 0x20 ? -1 : (*action >> 4);
             }
             best_actions_begin = NULL;
             best_actions_end = NULL;
+
+            if (delta_active) {
+                bomm_delta_commit(delta, plugboard);
+                best_score = bomm_delta_score(delta);
+            }
         }
     }
 
+    bomm_scratch_release(scratch, delta);
+
     if (measure == config->final_measure) {
         return best_score;
     }
@@ -297,6 +333,15 @@ bomm_pass_hill_climb_config_t* bomm_pass_hill_climb_config_init_with_json(
         }
     }
 
+    working_config.measure_scrambler =
+        bomm_measure_scrambler_function(working_config.measure);
+    working_config.measure_scrambler_bounded =
+        bomm_measure_scrambler_bounded_function(working_config.measure);
+    working_config.final_measure_scrambler =
+        bomm_measure_scrambler_function(working_config.final_measure);
+    working_config.final_measure_scrambler_bounded =
+        bomm_measure_scrambler_bounded_function(working_config.final_measure);
+
     if (!config && !(config = malloc(sizeof(working_config)))) {
         return NULL;
     }
@@ -11,6 +11,7 @@
 #include <jansson.h>
 #include "../measure.h"
 #include "../message.h"
+#include "../scratch.h"
 #include "../wiring.h"
 
 /**
@@ -27,6 +28,15 @@ typedef struct _bomm_pass_hill_climb_config {
      */
     bomm_measure_t final_measure;
 
+    /**
+     * Functions measuring the measure and the final measure; Resolved once
+     * along with the config
+     */
+    bomm_measure_scrambler_function_t measure_scrambler;
+    bomm_measure_scrambler_bounded_function_t measure_scrambler_bounded;
+    bomm_measure_scrambler_function_t final_measure_scrambler;
+    bomm_measure_scrambler_bounded_function_t final_measure_scrambler_bounded;
+
     /**
      * Minimum number of plugs that need to be assigned before switching
      * from the initial measure to the final measure
@@ -41,14 +51,19 @@ typedef struct _bomm_pass_hill_climb_config {
 } bomm_pass_hill_climb_config_t;
 
 /**
- * Run a hill climb pass on the given plugboard and scrambler
+ * Run a hill climb pass on the given plugboard and scrambler. Candidates are
+ * measured bounded by the best score found so far, if the measure allows it.
+ * @param scratch Scratch buffers of the attack or NULL
+ * @param num_aborts Counter of the measurements aborted early
  */
 double bomm_pass_hill_climb_run(
     bomm_pass_hill_climb_config_t* config,
     bomm_plugboard_t* plugboard,
     bomm_scrambler_t* scrambler,
     bomm_message_t* ciphertext,
-    unsigned int* num_decrypts
+    bomm_scratch_t* scratch,
+    unsigned int* num_decrypts,
+    unsigned int* num_aborts
 );
 
 /**
@@ -29,5 +29,6 @@ bomm_pass_measure_config_t* bomm_pass_measure_config_init_with_json(
     }
 
     config->measure = measure;
+    config->measure_scrambler = bomm_measure_scrambler_function(measure);
     return config;
 }
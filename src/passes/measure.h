@@ -18,6 +18,11 @@ typedef struct _bomm_pass_measure_config {
      * Measure
      */
     bomm_measure_t measure;
+
+    /**
+     * Function measuring the measure; Resolved once along with the config
+     */
+    bomm_measure_scrambler_function_t measure_scrambler;
 } bomm_pass_measure_config_t;
 
 /**
@@ -30,9 +35,8 @@ inline static double bomm_pass_measure_climb_run(
     bomm_message_t* ciphertext,
     unsigned int* num_decrypts
 ) {
-    bomm_measure_t measure = config->measure;
     (*num_decrypts)++;
-    return bomm_measure_scrambler(measure, scrambler, plugboard, ciphertext);
+    return config->measure_scrambler(scrambler, plugboard, ciphertext);
 }
 
 /**
@@ -6,22 +6,71 @@
 //
 
 #include "reswapping.h"
+#include "../delta.h"
 #include "../utility.h"
 
+/**
+ * Measure a candidate incrementally, if possible, or bounded by the best score
+ * found so far, if the measure allows it.
+ */
+static inline double _bomm_pass_reswapping_measure(
+    bomm_delta_t* delta,
+    bomm_measure_scrambler_function_t measure_scrambler,
+    bomm_measure_scrambler_bounded_function_t measure_scrambler_bounded,
+    bomm_plugboard_t* plugboard,
+    bomm_scrambler_t* scrambler,
+    bomm_message_t* ciphertext,
+    double best_score,
+    unsigned int* num_aborts
+) {
+    double score;
+    if (delta != NULL) {
+        score = bomm_delta_measure(delta, plugboard);
+    } else if (measure_scrambler_bounded != NULL) {
+        score = measure_scrambler_bounded(
+            scrambler, plugboard, ciphertext, best_score);
+    } else {
+        score = measure_scrambler(scrambler, plugboard, ciphertext);
+    }
+    if (score == BOMM_MEASURE_ABORTED) {
+        (*num_aborts)++;
+    }
+    return score;
+}
+
 double bomm_pass_reswapping_run(
     bomm_pass_reswapping_config_t* config,
     bomm_plugboard_t* plugboard,
     bomm_scrambler_t* scrambler,
     bomm_message_t* ciphertext,
-    unsigned int* num_decrypts
+    bomm_scratch_t* scratch,
+    unsigned int* num_decrypts,
+    unsigned int* num_aborts
 ) {
-    bomm_measure_t measure = config->measure;
+    bomm_measure_scrambler_function_t measure_scrambler =
+        config->measure_scrambler;
+    bomm_measure_scrambler_bounded_function_t measure_scrambler_bounded =
+        config->measure_scrambler_bounded;
+
+    // Sinkov measures with a loaded n-gram map as well as IC and entropy
+    // measures up to bigrams are evaluated incrementally (see `bomm_delta_t`)
+    bomm_delta_t* delta = NULL;
+    if (bomm_delta_supports(config->measure)) {
+        delta = bomm_delta_init(
+            bomm_scratch_delta(scratch, ciphertext->length),
+            config->measure,
+            scrambler,
+            plugboard,
+            ciphertext
+        );
+    }
 
     (*num_decrypts)++;
 
     double score;
-    double best_score = bomm_measure_scrambler(
-        measure, scrambler, plugboard, ciphertext);
+    double best_score = delta != NULL
+        ? bomm_delta_score(delta)
+        : measure_scrambler(scrambler, plugboard, ciphertext);
 
     unsigned int i, k, x;
     unsigned int best_reswap[4];
@@ -36,16 +85,18 @@ double bomm_pass_reswapping_run(
                 k = plugboard->map[i];
 
                 // Remove stecker i, k
-                bomm_swap(&plugboard->map[i], &plugboard->map[k]);
+                bomm_swap_letter(&plugboard->map[i], &plugboard->map[k]);
 
                 // Enumerate self-steckered letters x
                 for (x = 0; x < BOMM_ALPHABET_SIZE; x++) {
                     if (plugboard->map[x] == x) {
                         // Measure stecker i, x
-                        bomm_swap(&plugboard->map[i], &plugboard->map[x]);
+                        bomm_swap_letter(&plugboard->map[i], &plugboard->map[x]);
                         (*num_decrypts)++;
-                        score = bomm_measure_scrambler(
-                            measure, scrambler, plugboard, ciphertext);
+                        score = _bomm_pass_reswapping_measure(
+                            delta, measure_scrambler, measure_scrambler_bounded,
+                            plugboard, scrambler, ciphertext, best_score,
+                            num_aborts);
                         if (score > best_score) {
                             best_score = score;
                             best_reswap[0] = i;
@@ -54,13 +105,15 @@ double bomm_pass_reswapping_run(
                             best_reswap[3] = x;
                             found_improvement = true;
                         }
-                        bomm_swap(&plugboard->map[i], &plugboard->map[x]);
+                        bomm_swap_letter(&plugboard->map[i], &plugboard->map[x]);
 
                         // Measure stecker k, x
-                        bomm_swap(&plugboard->map[k], &plugboard->map[x]);
+                        bomm_swap_letter(&plugboard->map[k], &plugboard->map[x]);
                         (*num_decrypts)++;
-                        score = bomm_measure_scrambler(
-                            measure, scrambler, plugboard, ciphertext);
+                        score = _bomm_pass_reswapping_measure(
+                            delta, measure_scrambler, measure_scrambler_bounded,
+                            plugboard, scrambler, ciphertext, best_score,
+                            num_aborts);
                         if (score > best_score) {
                             best_score = score;
                             best_reswap[0] = i;
@@ -69,28 +122,34 @@ double bomm_pass_reswapping_run(
                             best_reswap[3] = x;
                             found_improvement = true;
                         }
-                        bomm_swap(&plugboard->map[k], &plugboard->map[x]);
+                        bomm_swap_letter(&plugboard->map[k], &plugboard->map[x]);
                     }
                 }
 
                 // Add stecker i, k
-                bomm_swap(&plugboard->map[i], &plugboard->map[k]);
+                bomm_swap_letter(&plugboard->map[i], &plugboard->map[k]);
             }
         }
 
         // Apply best scoring reswap, if any
         if (found_improvement) {
-            bomm_swap(
+            bomm_swap_letter(
                 &plugboard->map[best_reswap[0]],
                 &plugboard->map[best_reswap[1]]
             );
-            bomm_swap(
+            bomm_swap_letter(
                 &plugboard->map[best_reswap[2]],
                 &plugboard->map[best_reswap[3]]
             );
+
+            if (delta != NULL) {
+                bomm_delta_commit(delta, plugboard);
+                best_score = bomm_delta_score(delta);
+            }
         }
     }
 
+    bomm_scratch_release(scratch, delta);
     return best_score;
 }
 
@@ -115,6 +174,11 @@ bomm_pass_reswapping_config_t* bomm_pass_reswapping_config_init_with_json(
         }
     }
 
+    working_config.measure_scrambler =
+        bomm_measure_scrambler_function(working_config.measure);
+    working_config.measure_scrambler_bounded =
+        bomm_measure_scrambler_bounded_function(working_config.measure);
+
     if (!config && !(config = malloc(sizeof(working_config)))) {
         return NULL;
     }
@@ -10,6 +10,7 @@
 
 #include "../measure.h"
 #include "../message.h"
+#include "../scratch.h"
 #include "../wiring.h"
 
 /**
@@ -20,19 +21,31 @@ typedef struct _bomm_pass_reswapping_config {
      * Measure to be used
      */
     bomm_measure_t measure;
+
+    /**
+     * Functions measuring the measure; Resolved once along with the config
+     */
+    bomm_measure_scrambler_function_t measure_scrambler;
+    bomm_measure_scrambler_bounded_function_t measure_scrambler_bounded;
 } bomm_pass_reswapping_config_t;
 
 /**
  * Run a reswapping pass on the given plugboard and scrambler. Reverse
  * engineered from the reswapping pass implemented in the enigma-suite project.
+ * Candidates are measured bounded by the best score found so far, if the
+ * measure allows it.
  * @see https://www.bytereef.org/enigma-suite.html
+ * @param scratch Scratch buffers of the attack or NULL
+ * @param num_aborts Counter of the measurements aborted early
  */
 double bomm_pass_reswapping_run(
     bomm_pass_reswapping_config_t* config,
     bomm_plugboard_t* plugboard,
     bomm_scrambler_t* scrambler,
     bomm_message_t* ciphertext,
-    unsigned int* num_decrypts
+    bomm_scratch_t* scratch,
+    unsigned int* num_decrypts,
+    unsigned int* num_aborts
 );
 
 /**
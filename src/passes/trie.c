@@ -19,16 +19,12 @@ double bomm_pass_trie_climb_run(
     double score,
     unsigned int* num_decrypts
 ) {
-    size_t message_size = bomm_message_size_for_length(ciphertext->length);
-    bomm_message_t* plaintext = malloc(message_size);
-    if (plaintext) {
-        bomm_scrambler_encrypt(scrambler, plugboard, ciphertext, plaintext);
-        (*num_decrypts)++;
-        if (config->base_measure != BOMM_MEASURE_NONE) {
-            score = bomm_measure_message(config->base_measure, plaintext);
-        }
-        score += bomm_trie_measure_message(config->trie, plaintext);
+    (*num_decrypts)++;
+    if (config->base_measure != BOMM_MEASURE_NONE) {
+        score = config->base_measure_scrambler(scrambler, plugboard, ciphertext);
     }
+    score += bomm_trie_automaton_measure_scrambler(
+        config->automaton, scrambler, plugboard, ciphertext);
     return score;
 }
 
@@ -47,6 +43,8 @@ bomm_pass_trie_config_t* bomm_pass_trie_config_init_with_json(
 
     json_t* base_measure_json = json_object_get(config_json, "baseMeasure");
     config->base_measure = bomm_measure_from_json(base_measure_json);
+    config->base_measure_scrambler =
+        bomm_measure_scrambler_function(config->base_measure);
 
     json_t* trie_json = json_object_get(config_json, "trie");
     config->trie = bomm_trie_init_with_json(NULL, trie_json);
@@ -58,6 +56,16 @@ bomm_pass_trie_config_t* bomm_pass_trie_config_init_with_json(
         return NULL;
     }
 
+    config->automaton = bomm_trie_automaton_init(config->trie);
+    if (config->automaton == NULL) {
+        bomm_trie_destroy(config->trie);
+        free(config->trie);
+        if (owning) {
+            free(config);
+        }
+        return NULL;
+    }
+
     return config;
 }
 
@@ -65,4 +73,6 @@ void bomm_pass_trie_config_destroy(
     bomm_pass_trie_config_t* config
 ) {
     bomm_trie_destroy(config->trie);
+    free(config->trie);
+    free(config->automaton);
 }
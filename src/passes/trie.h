@@ -23,10 +23,20 @@ typedef struct _bomm_pass_trie_config {
      */
     bomm_trie_t* trie;
 
+    /**
+     * Automaton compiled from the trie the pass is scored with
+     */
+    bomm_trie_automaton_t* automaton;
+
     /**
      * Base measure
      */
     bomm_measure_t base_measure;
+
+    /**
+     * Function measuring the base measure; Resolved once along with the config
+     */
+    bomm_measure_scrambler_function_t base_measure_scrambler;
 } bomm_pass_trie_config_t;
 
 /**
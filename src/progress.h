@@ -35,6 +35,22 @@ typedef struct _bomm_progress {
      */
     unsigned long long num_decrypts;
 
+    /**
+     * Number of decrypts whose measurement has been aborted early, as they
+     * could no longer beat the best score
+     */
+    unsigned long long num_aborts;
+
+    /**
+     * Number of scrambler cache lookups
+     */
+    unsigned long num_cache_lookups;
+
+    /**
+     * Number of scrambler cache lookups that were served from the cache
+     */
+    unsigned long num_cache_hits;
+
     /**
      * Number of seconds elapsed so far.
      */
@@ -44,6 +60,12 @@ typedef struct _bomm_progress {
      * Duration of the last batch in seconds.
      */
     double batch_duration_sec;
+
+    /**
+     * Number of seconds parallel workloads spent idle after completing, while
+     * waiting for the slowest one to complete (joint progress only).
+     */
+    double tail_idle_sec;
 } bomm_progress_t;
 
 /**
@@ -58,8 +80,12 @@ static inline void bomm_progress_parallel(
     progress->num_units = 0;
     progress->num_units_completed = 0;
     progress->num_decrypts = 0;
+    progress->num_aborts = 0;
+    progress->num_cache_lookups = 0;
+    progress->num_cache_hits = 0;
     progress->duration_sec = 0;
     progress->batch_duration_sec = 0;
+    progress->tail_idle_sec = 0;
 
     for (unsigned int i = 0; i < size; i++) {
         bomm_progress_t* child = children[i];
@@ -67,6 +93,9 @@ static inline void bomm_progress_parallel(
         progress->num_units += child->num_units;
         progress->num_units_completed += child->num_units_completed;
         progress->num_decrypts += child->num_decrypts;
+        progress->num_aborts += child->num_aborts;
+        progress->num_cache_lookups += child->num_cache_lookups;
+        progress->num_cache_hits += child->num_cache_hits;
 
         if (child->duration_sec > progress->duration_sec) {
             progress->duration_sec = child->duration_sec;
@@ -80,6 +109,11 @@ static inline void bomm_progress_parallel(
             progress->batch_duration_sec = normalized_batch_duration;
         }
     }
+
+    for (unsigned int i = 0; i < size; i++) {
+        progress->tail_idle_sec +=
+            progress->duration_sec - children[i]->duration_sec;
+    }
 }
 
 /**
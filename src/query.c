@@ -10,12 +10,17 @@
 #include "query.h"
 #include "utility.h"
 #include "measure.h"
+#include "simd.h"
 
 static struct option _input_options[] = {
+    {"cache-size", required_argument, 0, 'c'},
     {"help", no_argument, 0, 'h'},
+    {"hold-file", required_argument, 0, 'o'},
+    {"kernels", required_argument, 0, 'k'},
     {"num-hold", no_argument, 0, 'n'},
     {"num-threads", no_argument, 0, 't'},
     {"quiet", no_argument, 0, 'q'},
+    {"shard", required_argument, 0, 's'},
     {"verbose", no_argument, 0, 'v'},
     {0, 0, 0, 0}
 };
@@ -34,22 +39,62 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
     bool quiet = false;
     unsigned int hold_size = 0;
     unsigned int num_threads = 0;
+    unsigned int cache_size = 0;
+    const char* hold_filename = NULL;
+    unsigned int shard = 1;
+    unsigned int num_shards = 1;
 
     // Read options
     int option;
     int option_index = 0;
-    while ((option = getopt_long(argc, argv, "hn:t:qv", _input_options, &option_index)) != -1) {
+    while ((option = getopt_long(argc, argv, "c:hk:n:o:s:t:qv", _input_options, &option_index)) != -1) {
         switch (option) {
+            case 'c': {
+                unsigned long int number = strtoul(optarg, NULL, 0);
+                if (number >= INT_MAX) {
+                    fprintf(
+                        stderr,
+                        "The number of scrambler cache entries must be less than %d\n",
+                        INT_MAX
+                    );
+                    return NULL;
+                }
+                cache_size = (unsigned int) number;
+                break;
+            }
             case 'h': {
                 printf("Usage: %s [-v] query_filename\n", argv[0]);
                 printf("Options:\n");
+                printf("  -c, --cache-size  number of scrambler cache entries per thread\n");
                 printf("  -h, --help        display this help message\n");
+                printf("  -k, --kernels     kernel variant to use (auto, scalar, avx2, avx512)\n");
                 printf("  -n, --num-hold    number of hold elements to collect\n");
+                printf("  -o, --hold-file   write the hold to the given JSON file when done\n");
+                printf("  -s, --shard       attack shard i of n of the key space (e.g. 2/4)\n");
                 printf("  -t, --num-threads number of concurrent threads to use\n");
                 printf("  -q, --quiet       quiet mode\n");
                 printf("  -v, --verbose     verbose mode\n");
                 return NULL;
             }
+            case 'k': {
+                if (strcmp(optarg, "auto") == 0) {
+                    break;
+                }
+                bomm_simd_t simd = bomm_simd_from_string(optarg);
+                if (simd == BOMM_SIMD_UNKNOWN) {
+                    fprintf(stderr, "Error: Unknown kernel variant %s\n", optarg);
+                    return NULL;
+                }
+                if (!bomm_simd_select(simd)) {
+                    fprintf(
+                        stderr,
+                        "Error: Kernel variant %s is not supported by this CPU\n",
+                        optarg
+                    );
+                    return NULL;
+                }
+                break;
+            }
             case 'n': {
                 unsigned long int number = strtoul(optarg, NULL, 0);
                 if (number >= INT_MAX) {
@@ -63,6 +108,26 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
                 hold_size = (unsigned int) number;
                 break;
             }
+            case 'o': {
+                hold_filename = optarg;
+                break;
+            }
+            case 's': {
+                char end;
+                if (
+                    sscanf(optarg, "%u/%u%c", &shard, &num_shards, &end) != 2 ||
+                    shard < 1 ||
+                    shard > num_shards
+                ) {
+                    fprintf(
+                        stderr,
+                        "Error: The shard is expected to be given as i/n " \
+                        "with 1 <= i <= n\n"
+                    );
+                    return NULL;
+                }
+                break;
+            }
             case 't': {
                 unsigned long int number = strtoul(optarg, NULL, 0);
                 if (number >= INT_MAX) {
@@ -87,6 +152,9 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
         }
     }
 
+    // Resolve the kernel variant once, before attack threads dispatch on it
+    bomm_simd_selected();
+
     // Make sure the query filename is given
     if (optind != argc - 1) {
         fprintf(stderr, "Error: A single argument with the query filename is expected\n");
@@ -158,10 +226,47 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
                     fprintf(stderr, "Error: The frequencies object is expected to hold string values\n");
                     return NULL;
                 }
-                if (bomm_measure_ngram_map_init(i + 1, json_string_value(frequencies_filename_json)) == NULL) {
+                if (!bomm_measure_ngram_model_init(i + 1, json_string_value(frequencies_filename_json))) {
+                    json_decref(query_json);
+                    return NULL;
+                }
+            }
+        }
+
+        // Quantize the n-gram maps, if requested
+        json_t* quantization_json = json_object_get(frequencies_json, "quantization");
+        if (quantization_json != NULL) {
+            const char* quantization_string = json_string_value(quantization_json);
+            bomm_ngram_quantization_t quantization;
+            if (quantization_string == NULL) {
+                quantization_string = "";
+            }
+            if (strcmp(quantization_string, "int8") == 0) {
+                quantization = BOMM_NGRAM_QUANTIZATION_INT8;
+            } else if (strcmp(quantization_string, "int16") == 0) {
+                quantization = BOMM_NGRAM_QUANTIZATION_INT16;
+            } else if (strcmp(quantization_string, "none") == 0) {
+                quantization = BOMM_NGRAM_QUANTIZATION_NONE;
+            } else {
+                json_decref(query_json);
+                fprintf(stderr, "Error: The frequencies quantization is expected to be one of 'none', 'int8', or 'int16'\n");
+                return NULL;
+            }
+            for (unsigned char n = 1; n <= 6; n++) {
+                if (
+                    bomm_ngram_map[n] != NULL &&
+                    !bomm_measure_ngram_qmap_init(n, quantization)
+                ) {
                     json_decref(query_json);
                     return NULL;
                 }
+                // Sparse maps only store the n-grams listed and are not quantized
+                if (
+                    bomm_ngram_sparse[n] != NULL &&
+                    quantization != BOMM_NGRAM_QUANTIZATION_NONE
+                ) {
+                    fprintf(stderr, "Warning: The sparse %d-gram map is not quantized\n", n);
+                }
             }
         }
     }
@@ -200,8 +305,21 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
                 return NULL;
             }
 
+            bomm_trie_automaton_t* automaton = bomm_trie_automaton_init(trie);
+            if (automaton == NULL) {
+                bomm_trie_destroy(trie);
+                free(trie);
+                free(bomm_measure_trie_config);
+                bomm_measure_trie_config = NULL;
+                json_decref(query_json);
+                return NULL;
+            }
+
             bomm_measure_trie_config->base_measure = base_measure;
+            bomm_measure_trie_config->base_measure_scrambler =
+                bomm_measure_scrambler_function(base_measure);
             bomm_measure_trie_config->trie = trie;
+            bomm_measure_trie_config->automaton = automaton;
         }
     }
 
@@ -249,11 +367,19 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
     query->hold = NULL;
     query->quiet = quiet;
     query->verbose = verbose;
+    query->cache_size = cache_size;
+    query->hold_filename = hold_filename;
+    query->shard = shard;
+    query->num_shards = num_shards;
     query->num_attacks = num_threads;
     query->joint_progress.batch_duration_sec = 0;
     query->joint_progress.duration_sec = 0;
+    query->joint_progress.tail_idle_sec = 0;
     query->joint_progress.num_batch_units = 26;
     query->joint_progress.num_decrypts = 0;
+    query->joint_progress.num_aborts = 0;
+    query->joint_progress.num_cache_lookups = 0;
+    query->joint_progress.num_cache_hits = 0;
     query->joint_progress.num_units = 0;
     query->joint_progress.num_units_completed = 0;
 
@@ -313,15 +439,12 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
         return NULL;
     }
 
-    // Split the key space into the requested number of concurrent threads
-    bomm_key_space_t key_space_slices[num_threads];
-    unsigned int num_attacks = bomm_key_space_slice(
-        &key_space,
-        num_threads,
-        key_space_slices
-    );
+    // Only enumerate keys whose scramblers differ within the ciphertext
+    key_space.message_length = query->ciphertext->length;
 
-    if (num_attacks == 0) {
+    // Count the keys once to be shared by the attacks
+    unsigned long num_keys = bomm_key_space_count(&key_space);
+    if (num_keys == 0) {
         bomm_query_destroy(query);
         json_decref(query_json);
         fprintf(
@@ -332,6 +455,39 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
         return NULL;
     }
 
+    // Restrict the key space to the given shard; Shard boundaries are put
+    // between scrambler settings, such that no scrambler is generated twice
+    if (num_shards > 1) {
+        unsigned long num_plugboards = bomm_key_space_plugboard_count(&key_space);
+        unsigned long num_units = (num_keys + num_plugboards - 1) / num_plugboards;
+        unsigned long start = (shard - 1) * num_units / num_shards * num_plugboards;
+        unsigned long end = shard * num_units / num_shards * num_plugboards;
+        end = end < num_keys ? end : num_keys;
+        if (start >= end) {
+            bomm_query_destroy(query);
+            json_decref(query_json);
+            fprintf(stderr, "Error: The shard %u/%u is empty\n", shard, num_shards);
+            return NULL;
+        }
+        key_space.offset += start;
+        key_space.limit = end - start;
+        num_keys = end - start;
+    }
+    key_space.num_keys = num_keys;
+
+    // Let the attacks claim chunks of the key space as they go, keeping the
+    // plugboard settings of a scrambler setting together
+    unsigned int num_attacks =
+        num_keys < (unsigned long) num_threads
+            ? (unsigned int) num_keys
+            : num_threads;
+    bomm_scheduler_init(
+        &query->scheduler,
+        num_keys,
+        num_attacks,
+        bomm_key_space_plugboard_count(&key_space)
+    );
+
     // Reduce the size of the query if necessary
     if (num_attacks != num_threads) {
         query->num_attacks = num_attacks;
@@ -344,7 +500,7 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
         bomm_attack_t* attack = &query->attacks[i];
         attack->query = query;
         attack->id = i + 1;
-        memcpy(&attack->key_space, &key_space_slices[i], sizeof(bomm_key_space_t));
+        memcpy(&attack->key_space, &key_space, sizeof(bomm_key_space_t));
         attack->num_passes = num_passes;
         memcpy(&attack->passes, &passes, num_passes * sizeof(bomm_pass_t));
         attack->ciphertext = query->ciphertext;
@@ -354,8 +510,13 @@ bomm_query_t* bomm_query_init(int argc, char *argv[]) {
         attack->progress.num_batch_units = 1;
         attack->progress.num_units_completed = 0;
         attack->progress.num_units = 0;
+        attack->progress.num_decrypts = 0;
+        attack->progress.num_aborts = 0;
+        attack->progress.num_cache_lookups = 0;
+        attack->progress.num_cache_hits = 0;
         attack->progress.duration_sec = 0;
         attack->progress.batch_duration_sec = 0;
+        attack->progress.tail_idle_sec = 0;
         pthread_mutex_init(&attack->mutex, NULL);
     }
 
@@ -437,6 +598,12 @@ void bomm_query_join(bomm_query_t* query) {
     }
 }
 
+bool bomm_query_save_hold(bomm_query_t* query) {
+    return
+        query->hold_filename == NULL ||
+        bomm_hold_save(query->hold, query->hold_filename, bomm_key_hold_serialize);
+}
+
 void bomm_query_print(bomm_query_t* query, unsigned int num_elements) {
     bomm_progress_t* attack_progress[query->num_attacks];
     for (unsigned int i = 0; i < query->num_attacks; i++) {
@@ -454,8 +621,10 @@ void bomm_query_print(bomm_query_t* query, unsigned int num_elements) {
         pthread_mutex_lock(&query->attacks[i].mutex);
     }
 
-    // Calculate joint progress
+    // Calculate joint progress; Attacks only know about the chunks they
+    // claimed so far, the scheduler knows the total number of keys
     bomm_progress_parallel(&query->joint_progress, attack_progress, query->num_attacks);
+    query->joint_progress.num_units = query->scheduler.num_keys;
 
     // Unlock progress updates
     for (unsigned int i = 0; i < query->num_attacks; i++) {
@@ -13,6 +13,7 @@
 #include "key.h"
 #include "message.h"
 #include "progress.h"
+#include "scheduler.h"
 #include "attack.h"
 #include "pass.h"
 
@@ -66,7 +67,8 @@ typedef struct _bomm_attack {
     unsigned int id;
 
     /**
-     * Target key space
+     * Target key space; Keys are drawn from it in chunks claimed from the
+     * query scheduler.
      */
     bomm_key_space_t key_space;
 
@@ -147,12 +149,36 @@ typedef struct _bomm_query {
      */
     bool verbose;
 
+    /**
+     * Number of scrambler cache entries per attack; Set to 0 to disable the
+     * scrambler cache.
+     */
+    unsigned int cache_size;
+
+    /**
+     * Path the hold is written to once the query finishes or NULL, if the
+     * hold should not be written to a file
+     */
+    const char* hold_filename;
+
+    /**
+     * Shard of the key space targeted by this process (starting at 1) and the
+     * number of shards the key space is split into
+     */
+    unsigned int shard;
+    unsigned int num_shards;
+
     /**
      * Joint progress of the embedded attacks;
      * Updated by calling `bomm_query_print`.
      */
     bomm_progress_t joint_progress;
 
+    /**
+     * Scheduler handing out chunks of the key space to the attacks
+     */
+    bomm_scheduler_t scheduler;
+
     /**
      * Number of attacks executed for this query
      */
@@ -196,6 +222,12 @@ void bomm_query_cancel(bomm_query_t* query);
  */
 void bomm_query_join(bomm_query_t* query);
 
+/**
+ * Write the query hold to the hold file, if set.
+ * @return False, if an error occurred.
+ */
+bool bomm_query_save_hold(bomm_query_t* query);
+
 /**
  * Print the status quo of the given query.
  * @param num_elements The number of hold entries to be included
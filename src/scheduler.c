@@ -0,0 +1,25 @@
+//
+//  scheduler.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <stdlib.h>
+#include "scheduler.h"
+
+bomm_scheduler_t* bomm_scheduler_init(
+    bomm_scheduler_t* scheduler,
+    unsigned long num_keys,
+    unsigned int num_workers,
+    unsigned long min_chunk_size
+) {
+    if (!scheduler && !(scheduler = malloc(sizeof(bomm_scheduler_t)))) {
+        return NULL;
+    }
+    scheduler->num_keys = num_keys;
+    scheduler->num_workers = num_workers > 0 ? num_workers : 1;
+    scheduler->min_chunk_size = min_chunk_size > 0 ? min_chunk_size : 1;
+    atomic_init(&scheduler->cursor, 0);
+    return scheduler;
+}
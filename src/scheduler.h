@@ -0,0 +1,99 @@
+//
+//  scheduler.h
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#ifndef scheduler_h
+#define scheduler_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/**
+ * Number of chunks the remaining keys are divided into per worker when
+ * claiming a chunk; The larger, the faster chunk sizes shrink.
+ */
+#define BOMM_SCHEDULER_CHUNKS_PER_WORKER 4
+
+/**
+ * Struct representing a scheduler handing out chunks of consecutive key
+ * indices to the attacks of a query on demand.
+ *
+ * Workers claim chunks from a shared atomic cursor as they go, such that
+ * workers getting through their keys faster (e.g. because hill climbs
+ * converge faster for their wheel orders) claim more chunks. Chunks are sized
+ * in proportion to the keys remaining (guided scheduling), so they start
+ * large to keep claims rare and shrink towards the end, where they determine
+ * how long workers wait for each other.
+ */
+typedef struct _bomm_scheduler {
+    /**
+     * Number of keys to be handed out
+     */
+    unsigned long num_keys;
+
+    /**
+     * Number of workers claiming chunks
+     */
+    unsigned int num_workers;
+
+    /**
+     * Minimum number of keys per chunk (unless fewer keys remain); Used to
+     * keep the keys sharing a scrambler setting together.
+     */
+    unsigned long min_chunk_size;
+
+    /**
+     * Index of the first key not claimed, yet
+     */
+    atomic_ulong cursor;
+} bomm_scheduler_t;
+
+/**
+ * Initialize a scheduler handing out the given number of keys.
+ * @param scheduler Pointer to an existing scheduler or NULL, if a new one
+ * should be allocated.
+ */
+bomm_scheduler_t* bomm_scheduler_init(
+    bomm_scheduler_t* scheduler,
+    unsigned long num_keys,
+    unsigned int num_workers,
+    unsigned long min_chunk_size
+);
+
+/**
+ * Claim the next chunk of keys. Safe to be called from multiple threads.
+ * @param start Set to the index of the first key in the chunk
+ * @param count Set to the number of keys in the chunk
+ * @return Returns false, if all keys have been claimed.
+ */
+static inline bool bomm_scheduler_claim(
+    bomm_scheduler_t* scheduler,
+    unsigned long* start,
+    unsigned long* count
+) {
+    unsigned long cursor = atomic_load(&scheduler->cursor);
+    unsigned long size;
+    do {
+        if (cursor >= scheduler->num_keys) {
+            return false;
+        }
+        unsigned long num_remaining = scheduler->num_keys - cursor;
+        size = num_remaining /
+            (scheduler->num_workers * BOMM_SCHEDULER_CHUNKS_PER_WORKER);
+        if (size < scheduler->min_chunk_size) {
+            size = scheduler->min_chunk_size;
+        }
+        if (size > num_remaining) {
+            size = num_remaining;
+        }
+    } while (!atomic_compare_exchange_weak(
+        &scheduler->cursor, &cursor, cursor + size));
+    *start = cursor;
+    *count = size;
+    return true;
+}
+
+#endif /* scheduler_h */
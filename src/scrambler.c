@@ -0,0 +1,344 @@
+//
+//  scrambler.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include "scrambler.h"
+#include "simd.h"
+
+/**
+ * Invalidate all entries of the composite reflector cache.
+ */
+static void _bomm_scrambler_engine_flush_composites(
+    bomm_scrambler_engine_t* engine
+) {
+    for (unsigned int i = 0; i < BOMM_SCRAMBLER_COMPOSITE_CACHE_SIZE; i++) {
+        engine->composites[i].tag = BOMM_SCRAMBLER_COMPOSITE_TAG_NONE;
+    }
+}
+
+/**
+ * Return true, if both keys place the same wheels in the given range of slots.
+ * If requested, the effective offsets of these slots need to match, too.
+ */
+static bool _bomm_scrambler_engine_slots_match(
+    const bomm_key_t* a,
+    const bomm_key_t* b,
+    unsigned int start,
+    unsigned int end,
+    bool match_offsets
+) {
+    bool match = true;
+    for (unsigned int slot = start; match && slot < end; slot++) {
+        match =
+            strcmp(a->wheels[slot].name, b->wheels[slot].name) == 0 &&
+            (
+                !match_offsets ||
+                bomm_wheel_offset(a->positions[slot], a->rings[slot]) ==
+                bomm_wheel_offset(b->positions[slot], b->rings[slot])
+            );
+    }
+    return match;
+}
+
+/**
+ * Fold the slots left of the left wheel into a fixed reflector. The stepping
+ * mechanism only ever moves the fast, middle, and left wheels.
+ */
+static void _bomm_scrambler_engine_fold_reflector(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_t* key
+) {
+    int num_reflector_slots = key->fast_wheel_slot > 2
+        ? (int) key->fast_wheel_slot - 2
+        : 0;
+    int slot;
+    engine->num_reflector_slots = num_reflector_slots;
+
+    for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        unsigned int x = letter;
+        for (slot = num_reflector_slots - 1; slot >= 0; slot--) {
+            x = engine->offset_maps[slot].map[
+                bomm_wheel_offset(key->positions[slot], key->rings[slot])][x];
+        }
+        for (slot = 1; slot < num_reflector_slots; slot++) {
+            x = engine->offset_maps[slot].rev[
+                bomm_wheel_offset(key->positions[slot], key->rings[slot])][x];
+        }
+        engine->reflector_map[letter] = x;
+    }
+}
+
+/**
+ * Compose the fast wheel with the slots right of it (e.g. the entry wheel)
+ * for each effective fast wheel offset.
+ */
+static void _bomm_scrambler_engine_fold_entry(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_t* key
+) {
+    int num_slots = key->num_slots;
+    int fast_slot = key->fast_wheel_slot;
+    const bomm_wheel_offset_maps_t* fast_wheel = &engine->offset_maps[fast_slot];
+    bomm_letter_t entry_map[BOMM_ALPHABET_SIZE];
+    bomm_letter_t entry_rev[BOMM_ALPHABET_SIZE];
+    unsigned int letter, offset;
+    int slot;
+
+    for (letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        unsigned int x = letter;
+        for (slot = num_slots - 1; slot > fast_slot; slot--) {
+            x = engine->offset_maps[slot].map[
+                bomm_wheel_offset(key->positions[slot], key->rings[slot])][x];
+        }
+        entry_map[letter] = x;
+
+        x = letter;
+        for (slot = fast_slot + 1; slot < num_slots; slot++) {
+            x = engine->offset_maps[slot].rev[
+                bomm_wheel_offset(key->positions[slot], key->rings[slot])][x];
+        }
+        entry_rev[letter] = x;
+    }
+
+    for (offset = 0; offset < BOMM_ALPHABET_SIZE; offset++) {
+        for (letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+            engine->entry_map[offset][letter] =
+                fast_wheel->map[offset][entry_map[letter]];
+            engine->entry_rev[offset][letter] =
+                entry_rev[fast_wheel->rev[offset][letter]];
+        }
+    }
+}
+
+/**
+ * Return the composite reflector formed by the slow slots (reflector and all
+ * wheels left of the fast wheel) at the given effective offsets. Computes and
+ * caches it, if it is not cached, yet.
+ */
+static inline const bomm_letter_t* _bomm_scrambler_engine_composite(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_t* state,
+    const unsigned int* offsets
+) {
+    int fast_slot = state->fast_wheel_slot;
+    unsigned int tag = 0;
+    int slot;
+    for (slot = 0; slot < fast_slot; slot++) {
+        tag = (tag << 5) | offsets[slot];
+    }
+
+    // Index the cache by the middle and left wheel offsets; The remaining slow
+    // slots (reflector, Greek wheel) rarely move and are covered by the tag
+    bomm_scrambler_composite_t* composite = &engine->composites[
+        offsets[fast_slot - 1] +
+        offsets[fast_slot - 2] * BOMM_ALPHABET_SIZE
+    ];
+    if (composite->tag == tag) {
+        return composite->map;
+    }
+
+    // Without fixed slots, the reflector is moved by the mechanism itself
+    int num_reflector_slots = engine->num_reflector_slots;
+    const bomm_letter_t* reflector_map = engine->reflector_map;
+    if (num_reflector_slots == 0) {
+        num_reflector_slots = 1;
+        reflector_map = engine->offset_maps[0].map[offsets[0]];
+    }
+
+    for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        unsigned int x = letter;
+
+        // Wheels (middle wheel, left wheel)
+        for (slot = fast_slot - 1; slot >= num_reflector_slots; slot--) {
+            x = engine->offset_maps[slot].map[offsets[slot]][x];
+        }
+
+        x = reflector_map[x];
+
+        // Wheels (left wheel, middle wheel)
+        for (slot = num_reflector_slots; slot < fast_slot; slot++) {
+            x = engine->offset_maps[slot].rev[offsets[slot]][x];
+        }
+
+        composite->map[letter] = x;
+    }
+
+    composite->tag = tag;
+    engine->num_composites++;
+    return composite->map;
+}
+
+/**
+ * Variant of `bomm_enigma_generate_letter_map` for the stepping mechanism
+ * sending letters through the entry stage, the composite reflector, and back.
+ */
+static inline void _bomm_scrambler_engine_generate_letter_map(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_t* state,
+    bomm_simd_t simd,
+    bomm_letter_t* map
+) {
+    unsigned int fast_slot = state->fast_wheel_slot;
+    unsigned int offsets[BOMM_MAX_NUM_SLOTS];
+    unsigned int slot;
+
+    // Only the offsets of the fast and the slow slots are relevant, the
+    // remaining slots have been folded into the entry stage
+    for (slot = 0; slot <= fast_slot; slot++) {
+        offsets[slot] =
+            bomm_wheel_offset(state->positions[slot], state->rings[slot]);
+    }
+
+    const bomm_letter_t* entry_map = engine->entry_map[offsets[fast_slot]];
+    const bomm_letter_t* entry_rev = engine->entry_rev[offsets[fast_slot]];
+    const bomm_letter_t* composite =
+        _bomm_scrambler_engine_composite(engine, state, offsets);
+
+    // Maps are followed by further maps in the engine, as required by the
+    // vectorized composition
+    bomm_simd_compose(simd, map, entry_map, composite, entry_rev);
+}
+
+bomm_scrambler_engine_t* bomm_scrambler_engine_init(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_space_t* key_space,
+    unsigned int length
+) {
+    if (!engine && !(engine = malloc(bomm_scrambler_engine_size(length)))) {
+        return NULL;
+    }
+
+    engine->length = length;
+    engine->simd = bomm_simd_selected();
+    engine->num_windows = 0;
+    engine->num_tapes = 0;
+    engine->num_scramblers = 0;
+    engine->num_composites = 0;
+    _bomm_scrambler_engine_flush_composites(engine);
+
+    for (unsigned int slot = 0; slot < BOMM_MAX_NUM_SLOTS; slot++) {
+        engine->position_masks[slot] =
+            key_space != NULL && slot < key_space->num_slots
+                ? key_space->position_masks[slot]
+                : BOMM_LETTERMASK_ALL;
+    }
+
+    return engine;
+}
+
+void bomm_scrambler_engine_generate(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_t* key
+) {
+    bomm_key_t* state = &engine->key;
+    unsigned int num_slots = key->num_slots;
+    unsigned int fast_slot = key->fast_wheel_slot;
+    bool stepping = key->mechanism == BOMM_MECHANISM_STEPPING;
+    unsigned int index, slot;
+
+    // Rebuild the offset maps of the slots a different wheel is placed in
+    for (slot = 0; slot < num_slots; slot++) {
+        if (
+            engine->num_tapes == 0 ||
+            slot >= state->num_slots ||
+            strcmp(state->wheels[slot].name, key->wheels[slot].name) != 0
+        ) {
+            bomm_wheel_offset_maps_init(
+                &engine->offset_maps[slot], &key->wheels[slot]);
+        }
+    }
+
+    // Fold the fixed slots and flush the composite reflector cache, if the
+    // slots they depend on changed
+    if (stepping) {
+        bool reuse =
+            engine->num_tapes > 0 &&
+            state->mechanism == BOMM_MECHANISM_STEPPING &&
+            state->num_slots == num_slots &&
+            state->fast_wheel_slot == fast_slot;
+        if (!reuse || !_bomm_scrambler_engine_slots_match(
+            state, key, 0, fast_slot, false
+        )) {
+            _bomm_scrambler_engine_flush_composites(engine);
+        }
+        if (!reuse || !_bomm_scrambler_engine_slots_match(
+            state, key, 0, fast_slot > 2 ? fast_slot - 2 : 0, true
+        )) {
+            _bomm_scrambler_engine_fold_reflector(engine, key);
+        }
+        if (!reuse ||
+            !_bomm_scrambler_engine_slots_match(
+                state, key, fast_slot, fast_slot + 1, false) ||
+            !_bomm_scrambler_engine_slots_match(
+                state, key, fast_slot + 1, num_slots, true)
+        ) {
+            _bomm_scrambler_engine_fold_entry(engine, key);
+        }
+    }
+
+    memcpy(state, key, sizeof(bomm_key_t));
+
+    // Store the original positions as we will reinstate them afterwards
+    unsigned int original_positions[num_slots];
+    memcpy(&original_positions, state->positions, sizeof(original_positions));
+
+    // Determine the maximum number of windows that may be requested, i.e. up
+    // to the last fast wheel position set in the mask
+    unsigned int max_num_windows = 1;
+    if (stepping) {
+        unsigned int position = original_positions[fast_slot];
+        bomm_lettermask_t mask = engine->position_masks[fast_slot];
+        for (unsigned int i = position + 1; i < BOMM_ALPHABET_SIZE; i++) {
+            if (bomm_lettermask_has(&mask, i)) {
+                max_num_windows = i - position + 1;
+            }
+        }
+    }
+
+    unsigned int num_windows = 1;
+    bool aligned = max_num_windows > 1;
+    bomm_simd_t simd = engine->simd;
+    for (index = 0; index < engine->length + num_windows - 1; index++) {
+        // Engaging the mechanism will change the key
+        if (stepping) {
+            bomm_enigma_engage_stepping(state);
+        } else {
+            bomm_enigma_engage_mechanism(state);
+        }
+
+        // The state after `index + 1` steps starts another window as long as
+        // the mechanism only moved the fast wheel so far
+        if (aligned) {
+            slot = 0;
+            while (aligned && slot < num_slots) {
+                aligned =
+                    slot == fast_slot ||
+                    state->positions[slot] == original_positions[slot];
+                slot++;
+            }
+            if (aligned && index + 2 <= max_num_windows) {
+                num_windows = index + 2;
+            } else {
+                aligned = false;
+            }
+        }
+
+        // Create map for this index
+        if (stepping) {
+            _bomm_scrambler_engine_generate_letter_map(
+                engine, state, simd, engine->tape[index]);
+        } else {
+            bomm_enigma_generate_letter_map(
+                engine->tape[index], state, engine->offset_maps);
+        }
+    }
+
+    // Reinstate original positions
+    memcpy(state->positions, &original_positions, sizeof(original_positions));
+
+    engine->num_windows = num_windows;
+    engine->num_tapes++;
+}
@@ -0,0 +1,243 @@
+//
+//  scrambler.h
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#ifndef scrambler_h
+#define scrambler_h
+
+#include "enigma.h"
+#include "key.h"
+#include "simd.h"
+#include "wiring.h"
+
+/**
+ * Number of entries in the composite reflector cache of a scrambler engine;
+ * Covers every combination of middle and left wheel offsets.
+ */
+#define BOMM_SCRAMBLER_COMPOSITE_CACHE_SIZE \
+    (BOMM_ALPHABET_SIZE * BOMM_ALPHABET_SIZE)
+
+/**
+ * Tag marking an empty composite reflector cache entry
+ */
+#define BOMM_SCRAMBLER_COMPOSITE_TAG_NONE UINT_MAX
+
+/**
+ * Struct representing a composite reflector, the permutation formed by the
+ * reflector and all wheels left of the fast wheel (i.e. the slow slots).
+ */
+typedef struct _bomm_scrambler_composite {
+    /**
+     * Effective offsets of the slow slots the composite has been computed
+     * for, packed into 5 bits per slot
+     */
+    unsigned int tag;
+
+    /**
+     * Composite map
+     */
+    bomm_letter_t map[BOMM_ALPHABET_SIZE];
+} bomm_scrambler_composite_t;
+
+/**
+ * Variable-size struct representing an engine generating scramblers for keys
+ * drawn from a key space.
+ *
+ * Using the stepping mechanism, the scrambler for fast wheel start position
+ * `p + 1` equals the scrambler for start position `p` shifted by one letter
+ * map, unless the mechanism steps the middle wheel in between. The engine
+ * makes use of this by generating a single tape of letter maps for a run of
+ * consecutive fast wheel start positions and serving each key as a window
+ * into it. The tape is only regenerated if a key is requested that is not
+ * covered by it (e.g. around turnovers or when changing wheels or rings).
+ *
+ * Between middle wheel steps, the reflector and the wheels left of the fast
+ * wheel form a fixed permutation. The engine caches this composite reflector
+ * per set of effective offsets of these slow slots, such that generating a
+ * letter map only needs to pass through the fast wheel (and entry wheel).
+ *
+ * Slots the stepping mechanism never moves are folded into fixed stages when
+ * a tape is generated for a key changing their wheels, rings, or positions:
+ * The slots left of the left wheel (e.g. thin reflector and Greek wheel) form
+ * a single reflector and the slots right of the fast wheel (e.g. the entry
+ * wheel) are composed into the fast wheel maps.
+ */
+typedef struct _bomm_scrambler_engine {
+    /**
+     * Number of letter maps per scrambler (i.e. the message length)
+     */
+    unsigned int length;
+
+    /**
+     * Set of fast wheel start positions that may be requested per slot; Used
+     * to avoid generating letter maps for windows that are never requested.
+     */
+    bomm_lettermask_t position_masks[BOMM_MAX_NUM_SLOTS];
+
+    /**
+     * Instruction set extension used to generate letter maps; Resolved once
+     * when initializing the engine.
+     */
+    bomm_simd_t simd;
+
+    /**
+     * Key the current tape has been generated for
+     */
+    bomm_key_t key;
+
+    /**
+     * Offset maps of the wheels placed in the slots of `key`; Rebuilt for a
+     * slot whenever a key places a different wheel in it.
+     */
+    bomm_wheel_offset_maps_t offset_maps[BOMM_MAX_NUM_SLOTS];
+
+    /**
+     * Number of consecutive fast wheel start positions (windows) the current
+     * tape serves, starting with the position of `key`. Set to 0 if the tape
+     * is empty.
+     */
+    unsigned int num_windows;
+
+    /**
+     * Number of tapes generated so far
+     */
+    unsigned long num_tapes;
+
+    /**
+     * Number of scramblers served so far
+     */
+    unsigned long num_scramblers;
+
+    /**
+     * Number of composite reflectors computed so far
+     */
+    unsigned long num_composites;
+
+    /**
+     * Number of slots folded into `reflector_map`
+     */
+    unsigned int num_reflector_slots;
+
+    /**
+     * Fixed reflector formed by the slots left of the left wheel (stepping
+     * mechanism only)
+     */
+    bomm_letter_t reflector_map[BOMM_ALPHABET_SIZE];
+
+    /**
+     * Forward map of the fast wheel composed with the slots right of it for
+     * each effective fast wheel offset (stepping mechanism only)
+     */
+    bomm_letter_t entry_map[BOMM_ALPHABET_SIZE][BOMM_ALPHABET_SIZE];
+
+    /**
+     * Reverse map of the fast wheel composed with the slots right of it for
+     * each effective fast wheel offset (stepping mechanism only)
+     */
+    bomm_letter_t entry_rev[BOMM_ALPHABET_SIZE][BOMM_ALPHABET_SIZE];
+
+    /**
+     * Composite reflector cache (stepping mechanism only); Valid for the
+     * wheels placed in the slow slots of `key`.
+     */
+    bomm_scrambler_composite_t composites[BOMM_SCRAMBLER_COMPOSITE_CACHE_SIZE];
+
+    /**
+     * Tape of letter maps; Holds up to `length + BOMM_ALPHABET_SIZE - 1`
+     * letter maps.
+     */
+    bomm_letter_t tape[][BOMM_ALPHABET_SIZE];
+} bomm_scrambler_engine_t;
+
+/**
+ * Calculate the scrambler engine struct size for the given message length.
+ */
+static inline size_t bomm_scrambler_engine_size(unsigned int length) {
+    return
+        sizeof(bomm_scrambler_engine_t) +
+        (length + BOMM_ALPHABET_SIZE - 1) *
+        BOMM_ALPHABET_SIZE * sizeof(bomm_letter_t);
+}
+
+/**
+ * Initialize a scrambler engine for the given key space and message length.
+ * @param engine Pointer to an engine of size `bomm_scrambler_engine_size` or
+ * NULL, if a new one should be allocated.
+ * @param key_space Key space the keys are drawn from or NULL, if arbitrary
+ * keys may be requested
+ */
+bomm_scrambler_engine_t* bomm_scrambler_engine_init(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_space_t* key_space,
+    unsigned int length
+);
+
+/**
+ * Generate a new tape starting with the given key.
+ */
+void bomm_scrambler_engine_generate(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_t* key
+);
+
+/**
+ * Return the window offset at which the current tape serves the scrambler of
+ * the given key or -1, if it is not covered by the tape.
+ */
+static inline int bomm_scrambler_engine_window(
+    const bomm_scrambler_engine_t* engine,
+    const bomm_key_t* key
+) {
+    if (engine->num_windows == 0 || key->mechanism != BOMM_MECHANISM_STEPPING) {
+        return -1;
+    }
+
+    const bomm_key_t* tape_key = &engine->key;
+    unsigned int fast_slot = key->fast_wheel_slot;
+    int offset =
+        (int) key->positions[fast_slot] - (int) tape_key->positions[fast_slot];
+    if (offset < 0 || offset >= (int) engine->num_windows) {
+        return -1;
+    }
+
+    // All other positions, the ring settings, and the wheels need to match
+    unsigned int num_slots = key->num_slots;
+    unsigned int slot = 0;
+    bool match = num_slots == tape_key->num_slots;
+    while (match && slot < num_slots) {
+        match =
+            (slot == fast_slot || key->positions[slot] == tape_key->positions[slot]) &&
+            key->rings[slot] == tape_key->rings[slot] &&
+            strcmp(key->wheels[slot].name, tape_key->wheels[slot].name) == 0;
+        slot++;
+    }
+    return match ? offset : -1;
+}
+
+/**
+ * Load the scrambler for the given key. Reuses the current tape, if possible.
+ * The key's plugboard is irrelevant when evaluating this function.
+ * @param scrambler Scrambler of the same length as the engine
+ */
+static inline void bomm_scrambler_engine_load(
+    bomm_scrambler_engine_t* engine,
+    const bomm_key_t* key,
+    bomm_scrambler_t* scrambler
+) {
+    int offset = bomm_scrambler_engine_window(engine, key);
+    if (offset == -1) {
+        bomm_scrambler_engine_generate(engine, key);
+        offset = 0;
+    }
+    memcpy(
+        scrambler->map,
+        engine->tape[offset],
+        engine->length * BOMM_ALPHABET_SIZE * sizeof(bomm_letter_t)
+    );
+    engine->num_scramblers++;
+}
+
+#endif /* scrambler_h */
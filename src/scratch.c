@@ -0,0 +1,21 @@
+//
+//  scratch.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include "scratch.h"
+
+bomm_scratch_t* bomm_scratch_init(bomm_scratch_t* scratch, unsigned int length) {
+    if (!scratch && !(scratch = malloc(bomm_scratch_size(length)))) {
+        return NULL;
+    }
+    scratch->length = length;
+    scratch->num_allocs = 0;
+    scratch->delta = (bomm_delta_t*) scratch->data;
+    scratch->plaintext = (bomm_message_t*)
+        (scratch->data + _bomm_scratch_words(bomm_delta_size(length)));
+    scratch->plaintext->length = length;
+    return scratch;
+}
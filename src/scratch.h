@@ -0,0 +1,130 @@
+//
+//  scratch.h
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#ifndef scratch_h
+#define scratch_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "delta.h"
+#include "message.h"
+
+/**
+ * Variable-size struct representing the scratch buffers of a single attack.
+ * Sized for the ciphertext length once, when the attack starts, and reused by
+ * the passes for every key, such that scoring does not touch the heap.
+ *
+ * Buffers requested for a longer message than the scratch has been sized for
+ * are allocated on the heap instead and counted, such that a non-zero count
+ * reveals allocations in the hot path.
+ */
+typedef struct _bomm_scratch {
+    /**
+     * Message length the buffers have been sized for
+     */
+    unsigned int length;
+
+    /**
+     * Number of buffers that had to be allocated on the heap so far
+     */
+    unsigned long long num_allocs;
+
+    /**
+     * Plaintext buffer
+     */
+    bomm_message_t* plaintext;
+
+    /**
+     * Incremental scorer buffer of size `bomm_delta_size(length)`
+     */
+    bomm_delta_t* delta;
+
+    /**
+     * Storage the buffers above point into
+     */
+    uint64_t data[];
+} bomm_scratch_t;
+
+/**
+ * Round the given size up to a whole number of storage words.
+ */
+static inline size_t _bomm_scratch_words(size_t size) {
+    return (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+}
+
+/**
+ * Calculate the scratch struct size for the given message length.
+ */
+static inline size_t bomm_scratch_size(unsigned int length) {
+    return
+        sizeof(bomm_scratch_t) +
+        (_bomm_scratch_words(bomm_delta_size(length)) +
+            _bomm_scratch_words(bomm_message_size_for_length(length))) *
+            sizeof(uint64_t);
+}
+
+/**
+ * Initialize a scratch for messages up to the given length.
+ * @param scratch Pointer to a scratch of size `bomm_scratch_size` or NULL, if
+ * a new one should be allocated.
+ */
+bomm_scratch_t* bomm_scratch_init(bomm_scratch_t* scratch, unsigned int length);
+
+/**
+ * Return an incremental scorer buffer for the given message length. Falls
+ * back to a heap allocation counted by the scratch, if the scratch is NULL or
+ * too small. Buffers need to be handed back using `bomm_scratch_release`.
+ * @return Returns NULL, if out of memory.
+ */
+static inline bomm_delta_t* bomm_scratch_delta(
+    bomm_scratch_t* scratch,
+    unsigned int length
+) {
+    if (scratch == NULL) {
+        return malloc(bomm_delta_size(length));
+    }
+    if (length > scratch->length) {
+        scratch->num_allocs++;
+        return malloc(bomm_delta_size(length));
+    }
+    return scratch->delta;
+}
+
+/**
+ * Return a plaintext buffer for the given message length. Falls back to a
+ * heap allocation counted by the scratch, if the scratch is NULL or too small.
+ * Buffers need to be handed back using `bomm_scratch_release`.
+ * @return Returns NULL, if out of memory.
+ */
+static inline bomm_message_t* bomm_scratch_plaintext(
+    bomm_scratch_t* scratch,
+    unsigned int length
+) {
+    if (scratch == NULL) {
+        return malloc(bomm_message_size_for_length(length));
+    }
+    if (length > scratch->length) {
+        scratch->num_allocs++;
+        return malloc(bomm_message_size_for_length(length));
+    }
+    return scratch->plaintext;
+}
+
+/**
+ * Hand back a buffer returned by the scratch, freeing it if it has been
+ * allocated on the heap.
+ */
+static inline void bomm_scratch_release(bomm_scratch_t* scratch, void* buffer) {
+    if (
+        scratch == NULL ||
+        (buffer != scratch->delta && buffer != scratch->plaintext)
+    ) {
+        free(buffer);
+    }
+}
+
+#endif /* scratch_h */
@@ -0,0 +1,782 @@
+//
+//  simd.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <string.h>
+#include "simd.h"
+
+#ifdef BOMM_SIMD_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Maximum alphabet size supported by the vectorized kernels; Plugboard lookups
+ * shuffle from a 32 byte table and strided indices reserve 5 bits per letter.
+ */
+#define BOMM_SIMD_MAX_ALPHABET_SIZE 32
+
+/**
+ * Best extension supported by the CPU or `BOMM_SIMD_UNKNOWN`, if not detected,
+ * yet
+ */
+static bomm_simd_t _bomm_simd_detection = BOMM_SIMD_UNKNOWN;
+
+/**
+ * Extension the kernels dispatched at runtime use or `BOMM_SIMD_UNKNOWN`, if
+ * not resolved, yet
+ */
+static bomm_simd_t _bomm_simd_selection = BOMM_SIMD_UNKNOWN;
+
+bomm_simd_t bomm_simd_detect(void) {
+    if (_bomm_simd_detection != BOMM_SIMD_UNKNOWN) {
+        return _bomm_simd_detection;
+    }
+    _bomm_simd_detection = BOMM_SIMD_NONE;
+#ifdef BOMM_SIMD_X86
+    if (BOMM_ALPHABET_SIZE <= BOMM_SIMD_MAX_ALPHABET_SIZE) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2")) {
+            _bomm_simd_detection = BOMM_SIMD_AVX512;
+        } else if (__builtin_cpu_supports("avx2")) {
+            _bomm_simd_detection = BOMM_SIMD_AVX2;
+        }
+    }
+#endif
+    return _bomm_simd_detection;
+}
+
+bool bomm_simd_select(bomm_simd_t simd) {
+    if (simd > bomm_simd_detect()) {
+        return false;
+    }
+    _bomm_simd_selection = simd;
+    return true;
+}
+
+bomm_simd_t bomm_simd_selected(void) {
+    if (_bomm_simd_selection == BOMM_SIMD_UNKNOWN) {
+        _bomm_simd_selection = bomm_simd_detect();
+    }
+    return _bomm_simd_selection;
+}
+
+bomm_simd_t bomm_simd_from_string(const char* string) {
+    if (strcmp(string, "scalar") == 0) {
+        return BOMM_SIMD_NONE;
+    } else if (strcmp(string, "avx2") == 0) {
+        return BOMM_SIMD_AVX2;
+    } else if (strcmp(string, "avx512") == 0) {
+        return BOMM_SIMD_AVX512;
+    }
+    return BOMM_SIMD_UNKNOWN;
+}
+
+const char* bomm_simd_to_string(bomm_simd_t simd) {
+    switch (simd) {
+        case BOMM_SIMD_AVX2:
+            return "avx2";
+        case BOMM_SIMD_AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+/**
+ * Compute the n-gram index of the window starting at the given position.
+ */
+static inline __attribute__((always_inline)) unsigned int _bomm_simd_window_index(
+    unsigned int n,
+    bomm_ngram_source_t source,
+    const bomm_letter_t* letters
+) {
+    unsigned int map_index = 0;
+    for (unsigned int k = 0; k < n; k++) {
+        map_index = source == BOMM_NGRAM_SOURCE_STRIDED
+            ? (map_index << BOMM_NGRAM_STRIDE_BITS) | letters[k]
+            : map_index * BOMM_ALPHABET_SIZE + letters[k];
+    }
+    return map_index;
+}
+
+/**
+ * Sum up the n-gram values of the windows in the given range one at a time.
+ */
+static double _bomm_simd_sinkov_sum_scalar(
+    unsigned int n,
+    bomm_ngram_source_t source,
+    const void* data,
+    const bomm_letter_t* letters,
+    unsigned int start,
+    unsigned int end
+) {
+    double sum = 0;
+    for (unsigned int window = start; window < end; window++) {
+        sum += bomm_ngram_value(
+            source, data, _bomm_simd_window_index(n, source, &letters[window]));
+    }
+    return sum;
+}
+
+#ifdef BOMM_SIMD_X86
+
+/**
+ * Return the array of values or levels gathered from for the given source.
+ */
+static inline __attribute__((always_inline)) const void* _bomm_simd_gather_base(
+    bomm_ngram_source_t source,
+    const void* data
+) {
+    switch (source) {
+        case BOMM_NGRAM_SOURCE_LEVELS8:
+        case BOMM_NGRAM_SOURCE_LEVELS16:
+            return ((const bomm_ngram_qmap_t*) data)->levels;
+        case BOMM_NGRAM_SOURCE_STRIDED:
+            return data;
+        default:
+            return ((const bomm_ngram_map_t*) data)->map;
+    }
+}
+
+/**
+ * Look up 32 letters (each below 32) in the given 32 byte table, broadcast to
+ * both 128-bit lanes as two halves.
+ */
+__attribute__((target("avx2")))
+static inline __m256i _bomm_simd_lookup_avx2(
+    __m256i table_low,
+    __m256i table_high,
+    __m256i letters
+) {
+    __m256i low = _mm256_shuffle_epi8(table_low, letters);
+    __m256i high = _mm256_shuffle_epi8(table_high, letters);
+    __m256i select = _mm256_cmpgt_epi8(letters, _mm256_set1_epi8(15));
+    return _mm256_blendv_epi8(low, high, select);
+}
+
+__attribute__((target("avx2")))
+static void _bomm_simd_compose_avx2(
+    bomm_letter_t* map,
+    const bomm_letter_t* a,
+    const bomm_letter_t* b,
+    const bomm_letter_t* c
+) {
+    __m256i b_table = _mm256_loadu_si256((const __m256i*) b);
+    __m256i c_table = _mm256_loadu_si256((const __m256i*) c);
+    __m256i x = _bomm_simd_lookup_avx2(
+        _mm256_permute2x128_si256(b_table, b_table, 0x00),
+        _mm256_permute2x128_si256(b_table, b_table, 0x11),
+        _mm256_loadu_si256((const __m256i*) a));
+    x = _bomm_simd_lookup_avx2(
+        _mm256_permute2x128_si256(c_table, c_table, 0x00),
+        _mm256_permute2x128_si256(c_table, c_table, 0x11),
+        x);
+
+    // Store exactly `BOMM_ALPHABET_SIZE` letters to not clobber what follows
+    uint8_t letters[32];
+    _mm256_storeu_si256((__m256i*) letters, x);
+    memcpy(map, letters, BOMM_ALPHABET_SIZE);
+}
+
+__attribute__((target("avx2")))
+static void _bomm_simd_plaintext_avx2(
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message,
+    bomm_letter_t* letters
+) {
+    unsigned int length = message->length;
+    unsigned int index = 0;
+
+    __m256i table_low = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) &plugboard->map[0]));
+    __m256i table_high = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) &plugboard->map[16]));
+
+    // Gathers read 4 bytes from each scrambler row, thus the last row is left
+    // to the scalar tail to not read past the scrambler
+    const int* rows = (const int*) scrambler->map;
+    __m256i row_offsets = _mm256_mullo_epi32(
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32(BOMM_ALPHABET_SIZE));
+    __m256i row_stride = _mm256_set1_epi32(8 * BOMM_ALPHABET_SIZE);
+    __m256i pack = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    __m256i join = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+
+    uint8_t inputs[32];
+    uint8_t outputs[32];
+    for (; index + 32 < length; index += 32) {
+        __m256i input = _bomm_simd_lookup_avx2(
+            table_low,
+            table_high,
+            _mm256_loadu_si256((const __m256i*) &message->letters[index]));
+        _mm256_storeu_si256((__m256i*) inputs, input);
+
+        __m256i offsets = _mm256_add_epi32(
+            row_offsets, _mm256_set1_epi32(index * BOMM_ALPHABET_SIZE));
+        for (unsigned int block = 0; block < 32; block += 8) {
+            __m256i output = _mm256_i32gather_epi32(
+                rows,
+                _mm256_add_epi32(offsets, _mm256_cvtepu8_epi32(
+                    _mm_loadl_epi64((const __m128i*) &inputs[block]))),
+                1);
+            output = _mm256_permutevar8x32_epi32(
+                _mm256_shuffle_epi8(output, pack), join);
+            _mm_storel_epi64(
+                (__m128i*) &outputs[block], _mm256_castsi256_si128(output));
+            offsets = _mm256_add_epi32(offsets, row_stride);
+        }
+
+        _mm256_storeu_si256(
+            (__m256i*) &letters[index],
+            _bomm_simd_lookup_avx2(
+                table_low,
+                table_high,
+                _mm256_loadu_si256((const __m256i*) outputs)));
+    }
+
+    for (; index < length; index++) {
+        unsigned int letter = message->letters[index];
+        letter = plugboard->map[letter];
+        letter = scrambler->map[index][letter];
+        letters[index] = plugboard->map[letter];
+    }
+}
+
+/**
+ * Sum up the n-gram values of 8 windows at a time using AVX2 gathers.
+ * @param source Passed as a constant to specialize the function
+ */
+__attribute__((target("avx2")))
+static inline __attribute__((always_inline)) double _bomm_simd_sinkov_sum_avx2(
+    unsigned int n,
+    bomm_ngram_source_t source,
+    const void* data,
+    const bomm_letter_t* letters,
+    unsigned int num_windows
+) {
+    const void* base = _bomm_simd_gather_base(source, data);
+    __m256d float_sums[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+    __m256i level_sums = _mm256_setzero_si256();
+    __m256i radix = _mm256_set1_epi32(BOMM_ALPHABET_SIZE);
+
+    unsigned int window = 0;
+    for (; window + 8 <= num_windows; window += 8) {
+        __m256i indices = _mm256_setzero_si256();
+        for (unsigned int k = 0; k < n; k++) {
+            __m256i letter = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((const __m128i*) &letters[window + k]));
+            indices = source == BOMM_NGRAM_SOURCE_STRIDED
+                ? _mm256_or_si256(
+                    _mm256_slli_epi32(indices, BOMM_NGRAM_STRIDE_BITS), letter)
+                : _mm256_add_epi32(_mm256_mullo_epi32(indices, radix), letter);
+        }
+
+        if (source == BOMM_NGRAM_SOURCE_LEVELS8 || source == BOMM_NGRAM_SOURCE_LEVELS16) {
+            // Gather the 32-bit words containing the levels to not read past
+            // the end of the levels array and shift them into place
+            unsigned int shift = source == BOMM_NGRAM_SOURCE_LEVELS8 ? 2 : 1;
+            __m256i words = _mm256_i32gather_epi32(
+                (const int*) base, _mm256_srli_epi32(indices, shift), 4);
+            __m256i offsets = _mm256_slli_epi32(
+                _mm256_and_si256(indices, _mm256_set1_epi32((1 << shift) - 1)),
+                5 - shift);
+            __m256i levels = _mm256_and_si256(
+                _mm256_srlv_epi32(words, offsets),
+                _mm256_set1_epi32(source == BOMM_NGRAM_SOURCE_LEVELS8 ? 0xff : 0xffff));
+            level_sums = _mm256_add_epi64(level_sums, _mm256_add_epi64(
+                _mm256_cvtepu32_epi64(_mm256_castsi256_si128(levels)),
+                _mm256_cvtepu32_epi64(_mm256_extracti128_si256(levels, 1))));
+        } else {
+            __m256 values = _mm256_i32gather_ps((const float*) base, indices, 4);
+            float_sums[0] = _mm256_add_pd(
+                float_sums[0], _mm256_cvtps_pd(_mm256_castps256_ps128(values)));
+            float_sums[1] = _mm256_add_pd(
+                float_sums[1], _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1)));
+        }
+    }
+
+    double sum;
+    if (source == BOMM_NGRAM_SOURCE_LEVELS8 || source == BOMM_NGRAM_SOURCE_LEVELS16) {
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i*) lanes, level_sums);
+        sum = (double) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    } else {
+        double lanes[4];
+        _mm256_storeu_pd(lanes, _mm256_add_pd(float_sums[0], float_sums[1]));
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+    return sum + _bomm_simd_sinkov_sum_scalar(
+        n, source, data, letters, window, num_windows);
+}
+
+/**
+ * Sum up the n-gram values of 16 windows at a time using AVX-512 gathers.
+ * @param source Passed as a constant to specialize the function
+ */
+__attribute__((target("avx512f")))
+static inline __attribute__((always_inline)) double _bomm_simd_sinkov_sum_avx512(
+    unsigned int n,
+    bomm_ngram_source_t source,
+    const void* data,
+    const bomm_letter_t* letters,
+    unsigned int num_windows
+) {
+    const void* base = _bomm_simd_gather_base(source, data);
+    __m512d float_sums[2] = { _mm512_setzero_pd(), _mm512_setzero_pd() };
+    __m512i level_sums = _mm512_setzero_si512();
+    __m512i radix = _mm512_set1_epi32(BOMM_ALPHABET_SIZE);
+
+    unsigned int window = 0;
+    for (; window + 16 <= num_windows; window += 16) {
+        __m512i indices = _mm512_setzero_si512();
+        for (unsigned int k = 0; k < n; k++) {
+            __m512i letter = _mm512_cvtepu8_epi32(
+                _mm_loadu_si128((const __m128i*) &letters[window + k]));
+            indices = source == BOMM_NGRAM_SOURCE_STRIDED
+                ? _mm512_or_si512(
+                    _mm512_slli_epi32(indices, BOMM_NGRAM_STRIDE_BITS), letter)
+                : _mm512_add_epi32(_mm512_mullo_epi32(indices, radix), letter);
+        }
+
+        if (source == BOMM_NGRAM_SOURCE_LEVELS8 || source == BOMM_NGRAM_SOURCE_LEVELS16) {
+            unsigned int shift = source == BOMM_NGRAM_SOURCE_LEVELS8 ? 2 : 1;
+            __m512i words = _mm512_i32gather_epi32(
+                _mm512_srli_epi32(indices, shift), base, 4);
+            __m512i offsets = _mm512_slli_epi32(
+                _mm512_and_si512(indices, _mm512_set1_epi32((1 << shift) - 1)),
+                5 - shift);
+            __m512i levels = _mm512_and_si512(
+                _mm512_srlv_epi32(words, offsets),
+                _mm512_set1_epi32(source == BOMM_NGRAM_SOURCE_LEVELS8 ? 0xff : 0xffff));
+            level_sums = _mm512_add_epi64(level_sums, _mm512_add_epi64(
+                _mm512_cvtepu32_epi64(_mm512_castsi512_si256(levels)),
+                _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(levels, 1))));
+        } else {
+            __m512 values = _mm512_i32gather_ps(indices, base, 4);
+            float_sums[0] = _mm512_add_pd(
+                float_sums[0], _mm512_cvtps_pd(_mm512_castps512_ps256(values)));
+            float_sums[1] = _mm512_add_pd(
+                float_sums[1], _mm512_cvtps_pd(_mm256_castpd_ps(
+                    _mm512_extractf64x4_pd(_mm512_castps_pd(values), 1))));
+        }
+    }
+
+    double sum;
+    if (source == BOMM_NGRAM_SOURCE_LEVELS8 || source == BOMM_NGRAM_SOURCE_LEVELS16) {
+        sum = (double) (uint64_t) _mm512_reduce_add_epi64(level_sums);
+    } else {
+        sum = _mm512_reduce_add_pd(_mm512_add_pd(float_sums[0], float_sums[1]));
+    }
+    return sum + _bomm_simd_sinkov_sum_scalar(
+        n, source, data, letters, window, num_windows);
+}
+
+/**
+ * Define functions summing up n-gram values specialized on the given source.
+ */
+#define BOMM_SIMD_SINKOV_SUM_FUNCTIONS(source)                                \
+    __attribute__((target("avx2")))                                           \
+    static double _bomm_simd_sinkov_sum_avx2_##source(                        \
+        unsigned int n,                                                       \
+        const void* data,                                                     \
+        const bomm_letter_t* letters,                                         \
+        unsigned int num_windows                                              \
+    ) {                                                                       \
+        return _bomm_simd_sinkov_sum_avx2(                                    \
+            n, BOMM_NGRAM_SOURCE_##source, data, letters, num_windows);       \
+    }                                                                         \
+    __attribute__((target("avx512f")))                                        \
+    static double _bomm_simd_sinkov_sum_avx512_##source(                      \
+        unsigned int n,                                                       \
+        const void* data,                                                     \
+        const bomm_letter_t* letters,                                         \
+        unsigned int num_windows                                              \
+    ) {                                                                       \
+        return _bomm_simd_sinkov_sum_avx512(                                  \
+            n, BOMM_NGRAM_SOURCE_##source, data, letters, num_windows);       \
+    }
+
+BOMM_SIMD_SINKOV_SUM_FUNCTIONS(MAP)
+BOMM_SIMD_SINKOV_SUM_FUNCTIONS(STRIDED)
+BOMM_SIMD_SINKOV_SUM_FUNCTIONS(LEVELS8)
+BOMM_SIMD_SINKOV_SUM_FUNCTIONS(LEVELS16)
+
+#undef BOMM_SIMD_SINKOV_SUM_FUNCTIONS
+
+/**
+ * Count monograms comparing 32 letters at a time against each letter. Matches
+ * are accumulated in per-lane byte counters that are folded into the
+ * frequencies before they could overflow.
+ */
+__attribute__((target("avx2")))
+static void _bomm_simd_monogram_frequency_avx2(
+    unsigned int* frequencies,
+    const bomm_letter_t* letters,
+    unsigned int length
+) {
+    unsigned int num_blocks = length / 32;
+    for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        __m256i needle = _mm256_set1_epi8((char) letter);
+        __m256i totals = _mm256_setzero_si256();
+        unsigned int block = 0;
+        while (block < num_blocks) {
+            unsigned int end = block + 255 < num_blocks ? block + 255 : num_blocks;
+            __m256i counters = _mm256_setzero_si256();
+            for (; block < end; block++) {
+                __m256i matches = _mm256_cmpeq_epi8(
+                    _mm256_loadu_si256((const __m256i*) &letters[block * 32]),
+                    needle);
+                counters = _mm256_sub_epi8(counters, matches);
+            }
+            totals = _mm256_add_epi64(
+                totals, _mm256_sad_epu8(counters, _mm256_setzero_si256()));
+        }
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i*) lanes, totals);
+        frequencies[letter] =
+            (unsigned int) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+
+    for (unsigned int index = num_blocks * 32; index < length; index++) {
+        frequencies[letters[index]]++;
+    }
+}
+
+/**
+ * Count bigrams computing the indices of 8 windows at a time.
+ */
+__attribute__((target("avx2")))
+static void _bomm_simd_bigram_frequency_avx2(
+    unsigned int* frequencies,
+    const bomm_letter_t* letters,
+    unsigned int length
+) {
+    memset(frequencies, 0, bomm_pow_map[2] * sizeof(unsigned int));
+    if (length < 2) {
+        return;
+    }
+
+    unsigned int num_windows = length - 1;
+    unsigned int indices[8];
+    __m256i radix = _mm256_set1_epi32(BOMM_ALPHABET_SIZE);
+    unsigned int window = 0;
+    for (; window + 8 <= num_windows; window += 8) {
+        __m256i first = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i*) &letters[window]));
+        __m256i second = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i*) &letters[window + 1]));
+        _mm256_storeu_si256(
+            (__m256i*) indices,
+            _mm256_add_epi32(_mm256_mullo_epi32(first, radix), second));
+        for (unsigned int lane = 0; lane < 8; lane++) {
+            frequencies[indices[lane]]++;
+        }
+    }
+
+    for (; window < num_windows; window++) {
+        frequencies[letters[window] * BOMM_ALPHABET_SIZE + letters[window + 1]]++;
+    }
+}
+
+#endif /* BOMM_SIMD_X86 */
+
+void bomm_simd_compose(
+    bomm_simd_t simd,
+    bomm_letter_t* map,
+    const bomm_letter_t* a,
+    const bomm_letter_t* b,
+    const bomm_letter_t* c
+) {
+#ifdef BOMM_SIMD_X86
+    if (simd >= BOMM_SIMD_AVX2) {
+        _bomm_simd_compose_avx2(map, a, b, c);
+        return;
+    }
+#else
+    (void) simd;
+#endif
+    for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        map[letter] = c[b[a[letter]]];
+    }
+}
+
+void bomm_simd_plaintext(
+    bomm_simd_t simd,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message,
+    bomm_letter_t* letters
+) {
+#ifdef BOMM_SIMD_X86
+    if (simd >= BOMM_SIMD_AVX2) {
+        _bomm_simd_plaintext_avx2(scrambler, plugboard, message, letters);
+        return;
+    }
+#else
+    (void) simd;
+#endif
+    for (unsigned int index = 0; index < message->length; index++) {
+        unsigned int letter = message->letters[index];
+        letter = plugboard->map[letter];
+        letter = scrambler->map[index][letter];
+        letters[index] = plugboard->map[letter];
+    }
+}
+
+double bomm_simd_sinkov_sum(
+    bomm_simd_t simd,
+    unsigned int n,
+    bomm_ngram_source_t source,
+    const bomm_letter_t* letters,
+    unsigned int length
+) {
+    if (length < n) {
+        return 0;
+    }
+    unsigned int num_windows = length - n + 1;
+    const void* data = bomm_ngram_source_data(n, source);
+
+#ifdef BOMM_SIMD_X86
+    if (simd == BOMM_SIMD_AVX512) {
+        switch (source) {
+            case BOMM_NGRAM_SOURCE_MAP:
+                return _bomm_simd_sinkov_sum_avx512_MAP(n, data, letters, num_windows);
+            case BOMM_NGRAM_SOURCE_STRIDED:
+                return _bomm_simd_sinkov_sum_avx512_STRIDED(n, data, letters, num_windows);
+            case BOMM_NGRAM_SOURCE_LEVELS8:
+                return _bomm_simd_sinkov_sum_avx512_LEVELS8(n, data, letters, num_windows);
+            case BOMM_NGRAM_SOURCE_LEVELS16:
+                return _bomm_simd_sinkov_sum_avx512_LEVELS16(n, data, letters, num_windows);
+            default:
+                break;
+        }
+    } else if (simd == BOMM_SIMD_AVX2) {
+        switch (source) {
+            case BOMM_NGRAM_SOURCE_MAP:
+                return _bomm_simd_sinkov_sum_avx2_MAP(n, data, letters, num_windows);
+            case BOMM_NGRAM_SOURCE_STRIDED:
+                return _bomm_simd_sinkov_sum_avx2_STRIDED(n, data, letters, num_windows);
+            case BOMM_NGRAM_SOURCE_LEVELS8:
+                return _bomm_simd_sinkov_sum_avx2_LEVELS8(n, data, letters, num_windows);
+            case BOMM_NGRAM_SOURCE_LEVELS16:
+                return _bomm_simd_sinkov_sum_avx2_LEVELS16(n, data, letters, num_windows);
+            default:
+                break;
+        }
+    }
+#else
+    (void) simd;
+#endif
+    return _bomm_simd_sinkov_sum_scalar(n, source, data, letters, 0, num_windows);
+}
+
+void bomm_simd_frequency(
+    bomm_simd_t simd,
+    unsigned int n,
+    unsigned int* frequencies,
+    const bomm_letter_t* letters,
+    unsigned int length
+) {
+#ifdef BOMM_SIMD_X86
+    if (simd >= BOMM_SIMD_AVX2 && n == 1) {
+        _bomm_simd_monogram_frequency_avx2(frequencies, letters, length);
+        return;
+    } else if (simd >= BOMM_SIMD_AVX2 && n == 2) {
+        _bomm_simd_bigram_frequency_avx2(frequencies, letters, length);
+        return;
+    }
+#else
+    (void) simd;
+#endif
+    unsigned int num_frequencies = bomm_pow_map[n];
+    memset(frequencies, 0, num_frequencies * sizeof(unsigned int));
+    unsigned int map_index = 0;
+    for (unsigned int index = 0; index < length; index++) {
+        map_index = (map_index * BOMM_ALPHABET_SIZE + letters[index]) % num_frequencies;
+        if (index >= n - 1) {
+            frequencies[map_index]++;
+        }
+    }
+}
+
+/**
+ * Measure the given plaintext letters using the vectorized kernels.
+ * @param measure Sinkov measure, or IC or entropy measure with n <= 2
+ */
+static inline __attribute__((always_inline)) double _bomm_simd_measure_letters(
+    bomm_measure_t measure,
+    bomm_simd_t simd,
+    const bomm_letter_t* letters,
+    unsigned int length
+) {
+    unsigned int n = measure & 0xf;
+    if (measure < BOMM_MEASURE_IC) {
+        bomm_ngram_source_t source = bomm_ngram_source(n);
+        double sum = bomm_simd_sinkov_sum(simd, n, source, letters, length);
+        return bomm_ngram_score(n, source, sum, length - n + 1);
+    }
+    unsigned int frequencies[bomm_pow_map[n]];
+    bomm_simd_frequency(simd, n, frequencies, letters, length);
+    return measure < BOMM_MEASURE_ENTROPY
+        ? bomm_measure_frequency_ic(n, frequencies)
+        : bomm_measure_frequency_entropy(n, frequencies);
+}
+
+/**
+ * Return true, if the given measure can be taken from plaintext letters by
+ * `_bomm_simd_measure_letters`.
+ */
+static inline bool _bomm_simd_measure_letters_supports(bomm_measure_t measure) {
+    return
+        (
+            measure >= BOMM_MEASURE_SINKOV_MONOGRAM &&
+            measure <= BOMM_MEASURE_SINKOV_HEXAGRAM
+        ) ||
+        measure == BOMM_MEASURE_IC ||
+        measure == BOMM_MEASURE_IC_BIGRAM ||
+        measure == BOMM_MEASURE_ENTROPY ||
+        measure == BOMM_MEASURE_ENTROPY_BIGRAM;
+}
+
+/**
+ * Measure a message put through the given scrambler and plugboard using the
+ * vectorized kernels.
+ * @param measure Passed as a constant to specialize the function
+ * @param simd Passed as a constant to specialize the function
+ */
+static inline __attribute__((always_inline)) double _bomm_simd_measure_scrambler(
+    bomm_measure_t measure,
+    bomm_simd_t simd,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message
+) {
+    // Trie measure: The automaton walks the letters one after another, so the
+    // plaintext is only materialized if the base measure can share it
+    if (measure == BOMM_MEASURE_TRIE) {
+        const bomm_measure_trie_config_t* config = bomm_measure_trie_config;
+        if (config == NULL) {
+            return 0;
+        }
+        if (!_bomm_simd_measure_letters_supports(config->base_measure)) {
+            double score = 0;
+            if (config->base_measure != BOMM_MEASURE_NONE) {
+                score = config->base_measure_scrambler(scrambler, plugboard, message);
+            }
+            return score + bomm_trie_automaton_measure_scrambler(
+                config->automaton, scrambler, plugboard, message);
+        }
+        bomm_letter_t letters[message->length];
+        bomm_simd_plaintext(simd, scrambler, plugboard, message, letters);
+        return
+            _bomm_simd_measure_letters(
+                config->base_measure, simd, letters, message->length) +
+            bomm_trie_automaton_measure_letters(
+                config->automaton, letters, message->length);
+    }
+
+    // Sparse maps are summed up by the scalar kernel without the plaintext
+    if (
+        measure < BOMM_MEASURE_IC &&
+        bomm_ngram_source(measure & 0xf) == BOMM_NGRAM_SOURCE_SPARSE
+    ) {
+        return bomm_measure_scrambler(measure, scrambler, plugboard, message);
+    }
+
+    bomm_letter_t letters[message->length];
+    bomm_simd_plaintext(simd, scrambler, plugboard, message, letters);
+    return _bomm_simd_measure_letters(measure, simd, letters, message->length);
+}
+
+/**
+ * Define a function measuring scramblers specialized on the given measure and
+ * instruction set extension.
+ */
+#define BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTION(measure, simd)                   \
+    static double _bomm_simd_measure_scrambler_##simd##_##measure(            \
+        bomm_scrambler_t* scrambler,                                          \
+        bomm_plugboard_t* plugboard,                                          \
+        bomm_message_t* message                                               \
+    ) {                                                                       \
+        return _bomm_simd_measure_scrambler(                                  \
+            BOMM_MEASURE_##measure, BOMM_SIMD_##simd,                         \
+            scrambler, plugboard, message);                                   \
+    }
+
+/**
+ * Define functions measuring scramblers specialized on the given measure for
+ * each instruction set extension.
+ */
+#define BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(measure)                        \
+    BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTION(measure, NONE)                       \
+    BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTION(measure, AVX2)                       \
+    BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTION(measure, AVX512)
+
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(SINKOV_MONOGRAM)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(SINKOV_BIGRAM)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(SINKOV_TRIGRAM)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(SINKOV_QUADGRAM)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(SINKOV_PENTAGRAM)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(SINKOV_HEXAGRAM)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(IC)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(IC_BIGRAM)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(ENTROPY)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(ENTROPY_BIGRAM)
+BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS(TRIE)
+
+#undef BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTIONS
+#undef BOMM_SIMD_MEASURE_SCRAMBLER_FUNCTION
+
+/**
+ * Define a lookup table entry mapping the given measure to its specialized
+ * functions per instruction set extension.
+ */
+#define BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(measure)                          \
+    { BOMM_MEASURE_##measure, {                                               \
+        _bomm_simd_measure_scrambler_NONE_##measure,                          \
+        _bomm_simd_measure_scrambler_AVX2_##measure,                          \
+        _bomm_simd_measure_scrambler_AVX512_##measure                         \
+    } }
+
+/**
+ * Lookup table mapping measure values to vectorized functions
+ */
+static const struct {
+    bomm_measure_t measure;
+    bomm_measure_scrambler_function_t functions[3];
+} _bomm_simd_measure_scrambler_function_map[] = {
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(SINKOV_MONOGRAM),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(SINKOV_BIGRAM),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(SINKOV_TRIGRAM),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(SINKOV_QUADGRAM),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(SINKOV_PENTAGRAM),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(SINKOV_HEXAGRAM),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(IC),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(IC_BIGRAM),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(ENTROPY),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(ENTROPY_BIGRAM),
+    BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING(TRIE),
+};
+
+#undef BOMM_SIMD_MEASURE_SCRAMBLER_MAPPING
+
+bomm_measure_scrambler_function_t bomm_simd_measure_scrambler_function(
+    bomm_measure_t measure,
+    bomm_simd_t simd
+) {
+    unsigned int num_mappings =
+        sizeof(_bomm_simd_measure_scrambler_function_map) /
+        sizeof(_bomm_simd_measure_scrambler_function_map[0]);
+    for (unsigned int i = 0; i < num_mappings; i++) {
+        if (_bomm_simd_measure_scrambler_function_map[i].measure == measure) {
+            return _bomm_simd_measure_scrambler_function_map[i].functions[simd];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,167 @@
+//
+//  simd.h
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#ifndef simd_h
+#define simd_h
+
+#include <stdbool.h>
+#include "measure.h"
+#include "message.h"
+#include "wiring.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * Defined if vectorized kernels are compiled in (x86 only); Kernels are
+ * compiled for their target using function attributes and selected at
+ * runtime, such that the binary still runs on baseline x86-64.
+ */
+#define BOMM_SIMD_X86
+#endif
+
+/**
+ * Instruction set extension used by the vectorized kernels; Ordered, such that
+ * every extension implies the ones before it.
+ */
+typedef enum {
+    /**
+     * Scalar fallback
+     */
+    BOMM_SIMD_NONE,
+
+    /**
+     * AVX2 (32 byte shuffles, 8 lane gathers)
+     */
+    BOMM_SIMD_AVX2,
+
+    /**
+     * AVX-512F (16 lane gathers); Other kernels run on AVX2.
+     */
+    BOMM_SIMD_AVX512,
+
+    /**
+     * Unknown instruction set extension
+     */
+    BOMM_SIMD_UNKNOWN = 0xff
+} bomm_simd_t;
+
+/**
+ * Return the best instruction set extension supported by the CPU. The CPU is
+ * only queried on the first call.
+ */
+bomm_simd_t bomm_simd_detect(void);
+
+/**
+ * Force the kernels dispatched at runtime to use the given instruction set
+ * extension. Needs to be called before starting attack threads.
+ * @return Returns false, if the extension is not supported by the CPU.
+ */
+bool bomm_simd_select(bomm_simd_t simd);
+
+/**
+ * Return the instruction set extension the kernels dispatched at runtime use,
+ * i.e. the one forced using `bomm_simd_select` or the best one supported by
+ * the CPU. Resolved once on the first call, which needs to happen before
+ * starting attack threads (see `bomm_query_init`).
+ */
+bomm_simd_t bomm_simd_selected(void);
+
+/**
+ * Return the instruction set extension for the given name or
+ * `BOMM_SIMD_UNKNOWN`, if not known.
+ */
+bomm_simd_t bomm_simd_from_string(const char* string);
+
+/**
+ * Return the name of the given instruction set extension.
+ */
+const char* bomm_simd_to_string(bomm_simd_t simd);
+
+/**
+ * Compose three letter maps, i.e. set `map[x] = c[b[a[x]]]`, using byte
+ * shuffles. Maps are loaded 32 bytes at a time, thus `a`, `b`, and `c` need
+ * to be followed by at least `32 - BOMM_ALPHABET_SIZE` readable bytes (e.g.
+ * further maps stored in the same struct).
+ */
+void bomm_simd_compose(
+    bomm_simd_t simd,
+    bomm_letter_t* map,
+    const bomm_letter_t* a,
+    const bomm_letter_t* b,
+    const bomm_letter_t* c
+);
+
+/**
+ * Put a message through the given scrambler and plugboard, i.e. derive the
+ * plaintext letters. Looks up 32 letters at a time in the plugboard using byte
+ * shuffles and gathers the scrambler output letters from the scrambler rows.
+ * @param letters Array of size `message->length` receiving the plaintext
+ */
+void bomm_simd_plaintext(
+    bomm_simd_t simd,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message,
+    bomm_letter_t* letters
+);
+
+/**
+ * Variant of `bomm_scrambler_encrypt` using `bomm_simd_plaintext`.
+ */
+static inline void bomm_simd_encrypt(
+    bomm_simd_t simd,
+    bomm_scrambler_t* scrambler,
+    bomm_plugboard_t* plugboard,
+    bomm_message_t* message,
+    bomm_message_t* result
+) {
+    result->length = message->length;
+    bomm_simd_plaintext(simd, scrambler, plugboard, message, result->letters);
+}
+
+/**
+ * Sum up the n-gram values (or levels, if quantized) of the given plaintext
+ * letters in the given source. Computes the n-gram indices of 8 (AVX2) or 16
+ * (AVX-512) windows at once and gathers their values from the map. Matches
+ * the scalar sum up to rounding (exactly for quantized maps). Sparse maps are
+ * summed up by the scalar fallback.
+ * @param n The n in n-gram
+ */
+double bomm_simd_sinkov_sum(
+    bomm_simd_t simd,
+    unsigned int n,
+    bomm_ngram_source_t source,
+    const bomm_letter_t* letters,
+    unsigned int length
+);
+
+/**
+ * Count the n-gram frequencies of the given plaintext letters. Monograms are
+ * counted comparing 32 letters at a time against each letter, accumulating in
+ * per-lane byte counters. Bigram indices are computed 8 windows at a time.
+ * @param n The n in n-gram (1 or 2)
+ * @param frequencies Frequencies map of size `pow(BOMM_ALPHABET_SIZE, n)`
+ */
+void bomm_simd_frequency(
+    bomm_simd_t simd,
+    unsigned int n,
+    unsigned int* frequencies,
+    const bomm_letter_t* letters,
+    unsigned int length
+);
+
+/**
+ * Return the function measuring scramblers with the given measure using the
+ * vectorized kernels for the given instruction set extension or NULL, if the
+ * measure is not vectorized. Scores match `bomm_measure_scrambler` up to
+ * rounding.
+ */
+bomm_measure_scrambler_function_t bomm_simd_measure_scrambler_function(
+    bomm_measure_t measure,
+    bomm_simd_t simd
+);
+
+#endif /* simd_h */
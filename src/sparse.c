@@ -0,0 +1,181 @@
+//
+//  sparse.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <string.h>
+#include "sparse.h"
+
+/**
+ * Alignment of the sparse map allocation (cache line size)
+ */
+#define BOMM_SPARSE_ALIGNMENT 64
+
+/**
+ * Insert a key into the given bucket, if it is stored there already or if
+ * there is an empty slot left.
+ */
+static inline bool _bomm_sparse_bucket_insert(
+    bomm_sparse_bucket_t* bucket,
+    uint32_t key,
+    float value
+) {
+    for (unsigned int slot = 0; slot < BOMM_SPARSE_BUCKET_SIZE; slot++) {
+        if (bucket->keys[slot] == key || bucket->keys[slot] == BOMM_SPARSE_KEY_NONE) {
+            bucket->keys[slot] = key;
+            bucket->values[slot] = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Insert an entry into the cuckoo hash table, evicting entries to their
+ * alternate bucket as needed.
+ * @return Returns false, if no place could be found. In this case, the table
+ * has lost an entry and needs to be rebuilt with more buckets.
+ */
+static bool _bomm_sparse_insert(
+    bomm_sparse_t* sparse,
+    uint32_t key,
+    float value
+) {
+    uint64_t bloom_hash = bomm_sparse_bloom_hash(key);
+    sparse->bloom[bloom_hash & sparse->bloom_mask] |=
+        bomm_sparse_bloom_bits(bloom_hash);
+
+    uint64_t bucket_hash = bomm_sparse_bucket_hash(key);
+    unsigned int first = bucket_hash & sparse->bucket_mask;
+    unsigned int second = (bucket_hash >> 32) & sparse->bucket_mask;
+
+    // Keys stored more than once take the value given last
+    for (unsigned int slot = 0; slot < BOMM_SPARSE_BUCKET_SIZE; slot++) {
+        if (sparse->buckets[first].keys[slot] == key) {
+            sparse->buckets[first].values[slot] = value;
+            return true;
+        }
+        if (sparse->buckets[second].keys[slot] == key) {
+            sparse->buckets[second].values[slot] = value;
+            return true;
+        }
+    }
+
+    sparse->num_entries++;
+    if (
+        _bomm_sparse_bucket_insert(&sparse->buckets[first], key, value) ||
+        _bomm_sparse_bucket_insert(&sparse->buckets[second], key, value)
+    ) {
+        return true;
+    }
+
+    // Evict a pseudo-random slot and move its entry to its alternate bucket
+    unsigned int index = first;
+    uint32_t random = key;
+    for (unsigned int kick = 0; kick < BOMM_SPARSE_MAX_NUM_KICKS; kick++) {
+        random = random * 1103515245 + 12345;
+        unsigned int slot = (random >> 16) % BOMM_SPARSE_BUCKET_SIZE;
+        bomm_sparse_bucket_t* bucket = &sparse->buckets[index];
+
+        uint32_t evicted_key = bucket->keys[slot];
+        float evicted_value = bucket->values[slot];
+        bucket->keys[slot] = key;
+        bucket->values[slot] = value;
+        key = evicted_key;
+        value = evicted_value;
+
+        bucket_hash = bomm_sparse_bucket_hash(key);
+        first = bucket_hash & sparse->bucket_mask;
+        second = (bucket_hash >> 32) & sparse->bucket_mask;
+        index = first == index ? second : first;
+        if (_bomm_sparse_bucket_insert(&sparse->buckets[index], key, value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Allocate an empty sparse map with the given number of buckets and bloom
+ * filter words (both powers of two).
+ */
+static bomm_sparse_t* _bomm_sparse_alloc(
+    size_t num_buckets,
+    size_t num_bloom_words,
+    float fallback
+) {
+    size_t size =
+        sizeof(bomm_sparse_t) +
+        num_bloom_words * sizeof(uint64_t) +
+        num_buckets * sizeof(bomm_sparse_bucket_t);
+    size = (size + BOMM_SPARSE_ALIGNMENT - 1) /
+        BOMM_SPARSE_ALIGNMENT * BOMM_SPARSE_ALIGNMENT;
+
+    bomm_sparse_t* sparse = aligned_alloc(BOMM_SPARSE_ALIGNMENT, size);
+    if (!sparse) {
+        return NULL;
+    }
+
+    sparse->num_entries = 0;
+    sparse->bucket_mask = (unsigned int) (num_buckets - 1);
+    sparse->bloom_mask = (unsigned int) (num_bloom_words - 1);
+    sparse->fallback = fallback;
+    sparse->bloom = sparse->data;
+    sparse->buckets = (bomm_sparse_bucket_t*) &sparse->bloom[num_bloom_words];
+
+    memset(sparse->bloom, 0, num_bloom_words * sizeof(uint64_t));
+    for (size_t i = 0; i < num_buckets; i++) {
+        for (unsigned int slot = 0; slot < BOMM_SPARSE_BUCKET_SIZE; slot++) {
+            sparse->buckets[i].keys[slot] = BOMM_SPARSE_KEY_NONE;
+            sparse->buckets[i].values[slot] = fallback;
+        }
+    }
+    return sparse;
+}
+
+bomm_sparse_t* bomm_sparse_init(
+    const uint32_t* keys,
+    const float* values,
+    unsigned int num_entries,
+    float fallback
+) {
+    // Aim for a load factor of at most 90 %, doubling the number of buckets
+    // whenever the table cannot be built
+    size_t num_buckets = 1;
+    while (num_buckets * BOMM_SPARSE_BUCKET_SIZE * 9 < (size_t) num_entries * 10) {
+        num_buckets <<= 1;
+    }
+    size_t num_bloom_words = 1;
+    while (num_bloom_words * 64 < (size_t) num_entries * BOMM_SPARSE_BLOOM_BITS_PER_ENTRY) {
+        num_bloom_words <<= 1;
+    }
+
+    while (num_buckets <= (size_t) UINT32_MAX + 1) {
+        bomm_sparse_t* sparse =
+            _bomm_sparse_alloc(num_buckets, num_bloom_words, fallback);
+        if (!sparse) {
+            return NULL;
+        }
+
+        bool success = true;
+        for (unsigned int i = 0; success && i < num_entries; i++) {
+            success = _bomm_sparse_insert(sparse, keys[i], values[i]);
+        }
+        if (success) {
+            return sparse;
+        }
+
+        free(sparse);
+        num_buckets <<= 1;
+    }
+    return NULL;
+}
+
+size_t bomm_sparse_size(const bomm_sparse_t* sparse) {
+    return
+        sizeof(bomm_sparse_t) +
+        ((size_t) sparse->bloom_mask + 1) * sizeof(uint64_t) +
+        ((size_t) sparse->bucket_mask + 1) * sizeof(bomm_sparse_bucket_t);
+}
@@ -0,0 +1,160 @@
+//
+//  sparse.h
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#ifndef sparse_h
+#define sparse_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Number of slots per bucket
+ */
+#define BOMM_SPARSE_BUCKET_SIZE 4
+
+/**
+ * Key marking an empty slot; N-gram indices stay below `26^6`
+ */
+#define BOMM_SPARSE_KEY_NONE UINT32_MAX
+
+/**
+ * Number of bloom filter bits per entry
+ */
+#define BOMM_SPARSE_BLOOM_BITS_PER_ENTRY 8
+
+/**
+ * Maximum number of evictions before giving up on an insertion
+ */
+#define BOMM_SPARSE_MAX_NUM_KICKS 512
+
+/**
+ * Bucket of a sparse map; Two buckets share a cache line.
+ */
+typedef struct _bomm_sparse_bucket {
+    uint32_t keys[BOMM_SPARSE_BUCKET_SIZE];
+    float values[BOMM_SPARSE_BUCKET_SIZE];
+} bomm_sparse_bucket_t;
+
+/**
+ * Variable-size struct representing a sparse map from 32-bit keys (n-gram
+ * indices) to float values (log probabilities) returning a fallback value for
+ * keys not stored.
+ *
+ * Entries are stored in a bucketized cuckoo hash table, i.e. every key lives
+ * in one of two buckets and a lookup reads at most two cache lines. A blocked
+ * bloom filter in front of the table answers most lookups of keys not stored
+ * reading a single word.
+ */
+typedef struct _bomm_sparse {
+    /**
+     * Number of entries stored
+     */
+    unsigned int num_entries;
+
+    /**
+     * Number of buckets minus 1 (power of two)
+     */
+    unsigned int bucket_mask;
+
+    /**
+     * Number of bloom filter words minus 1 (power of two)
+     */
+    unsigned int bloom_mask;
+
+    /**
+     * Value returned for keys not stored
+     */
+    float fallback;
+
+    /**
+     * Bloom filter words
+     */
+    uint64_t* bloom;
+
+    /**
+     * Buckets
+     */
+    bomm_sparse_bucket_t* buckets;
+
+    /**
+     * Storage the bloom filter and buckets point into
+     */
+    uint64_t data[];
+} bomm_sparse_t;
+
+/**
+ * Build a sparse map from the given entries. Keys stored more than once take
+ * the value given last.
+ * @return Returns NULL on allocation failure.
+ */
+bomm_sparse_t* bomm_sparse_init(
+    const uint32_t* keys,
+    const float* values,
+    unsigned int num_entries,
+    float fallback
+);
+
+/**
+ * Return the size of the given sparse map in bytes.
+ */
+size_t bomm_sparse_size(const bomm_sparse_t* sparse);
+
+/**
+ * Hash used to place keys in the bloom filter.
+ */
+static inline uint64_t bomm_sparse_bloom_hash(uint32_t key) {
+    uint64_t hash = (key + 1) * 0x9e3779b97f4a7c15ULL;
+    return hash ^ (hash >> 29);
+}
+
+/**
+ * Hash used to place keys in buckets; The lower and upper half determine the
+ * two candidate buckets.
+ */
+static inline uint64_t bomm_sparse_bucket_hash(uint32_t key) {
+    uint64_t hash = (key ^ 0x5bd1e995ULL) * 0xbf58476d1ce4e5b9ULL;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * Return the bloom filter bits of the given hash.
+ */
+static inline uint64_t bomm_sparse_bloom_bits(uint64_t hash) {
+    return (1ULL << (hash >> 58)) | (1ULL << ((hash >> 52) & 63));
+}
+
+/**
+ * Look up the value of a key or return the fallback value, if not stored.
+ */
+static inline float bomm_sparse_lookup(
+    const bomm_sparse_t* sparse,
+    uint32_t key
+) {
+    uint64_t bloom_hash = bomm_sparse_bloom_hash(key);
+    uint64_t bits = bomm_sparse_bloom_bits(bloom_hash);
+    if ((sparse->bloom[bloom_hash & sparse->bloom_mask] & bits) != bits) {
+        return sparse->fallback;
+    }
+
+    uint64_t bucket_hash = bomm_sparse_bucket_hash(key);
+    const bomm_sparse_bucket_t* first =
+        &sparse->buckets[bucket_hash & sparse->bucket_mask];
+    const bomm_sparse_bucket_t* second =
+        &sparse->buckets[(bucket_hash >> 32) & sparse->bucket_mask];
+    for (unsigned int slot = 0; slot < BOMM_SPARSE_BUCKET_SIZE; slot++) {
+        if (first->keys[slot] == key) {
+            return first->values[slot];
+        }
+        if (second->keys[slot] == key) {
+            return second->values[slot];
+        }
+    }
+    return sparse->fallback;
+}
+
+#endif /* sparse_h */
@@ -56,6 +56,74 @@ bool bomm_trie_insert(
     return _bomm_trie_insert(trie, word, 0, num_garbles, value);
 }
 
+/**
+ * Count the nodes of the given trie.
+ */
+static unsigned int _bomm_trie_count(const bomm_trie_t* trie) {
+    unsigned int count = 1;
+    for (unsigned int i = 0; i < BOMM_ALPHABET_SIZE; i++) {
+        if (trie->children[i]) {
+            count += _bomm_trie_count(trie->children[i]);
+        }
+    }
+    return count;
+}
+
+bomm_trie_automaton_t* bomm_trie_automaton_init(const bomm_trie_t* trie) {
+    unsigned int num_states = _bomm_trie_count(trie);
+    bomm_trie_automaton_t* automaton = malloc(
+        sizeof(bomm_trie_automaton_t) + num_states * sizeof(bomm_trie_state_t));
+    const bomm_trie_t** nodes = malloc(num_states * sizeof(bomm_trie_t*));
+    unsigned int* failures = malloc(num_states * sizeof(unsigned int));
+    if (!automaton || !nodes || !failures) {
+        free(automaton);
+        free(nodes);
+        free(failures);
+        return NULL;
+    }
+
+    // Visit the nodes in breadth-first order, such that the failure state of
+    // a node (the state of its longest proper suffix) is complete before
+    // the node itself is visited
+    bomm_trie_state_t* states = automaton->states;
+    unsigned int num_visited = 1;
+    nodes[0] = trie;
+    failures[0] = 0;
+    states[0].output = 0;
+    for (unsigned int state = 0; state < num_visited; state++) {
+        const bomm_trie_t* node = nodes[state];
+        for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+            const bomm_trie_t* child = node->children[letter];
+            unsigned int failure_next = state == 0
+                ? 0
+                : states[failures[state]].transitions[letter];
+            if (child) {
+                unsigned int next = num_visited++;
+                nodes[next] = child;
+                failures[next] = failure_next;
+                states[next].output = child->value + states[failure_next].output;
+                states[state].transitions[letter] = next;
+            } else {
+                states[state].transitions[letter] = failure_next;
+            }
+        }
+    }
+
+    // The root value is added at every offset the walk restarts at
+    automaton->num_states = num_states;
+    automaton->max_output = -INFINITY;
+    for (unsigned int state = 0; state < num_states; state++) {
+        states[state].output += trie->value;
+        if (states[state].output > automaton->max_output) {
+            automaton->max_output = states[state].output;
+        }
+    }
+
+    free(nodes);
+    free(failures);
+    return automaton;
+}
+
 void _bomm_trie_debug_prefixed(bomm_trie_t* trie, const char* prefix) {
     char child_prefix[strlen(prefix) + 16];
     snprintf(child_prefix, sizeof(child_prefix), "%s│  ", prefix);
@@ -10,7 +10,9 @@
 
 #include <jansson.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "message.h"
+#include "wiring.h"
 
 /**
  * Struct representing a node in a trie (tree data structure)
@@ -71,6 +73,145 @@ static inline double bomm_trie_measure_message(
     return score;
 }
 
+/**
+ * State of a trie automaton
+ */
+typedef struct _bomm_trie_state {
+    /**
+     * Score added when entering this state: The value of the root plus the
+     * values of all trie nodes matching a suffix of the text read so far
+     */
+    double output;
+
+    /**
+     * Next state per letter read
+     */
+    uint32_t transitions[BOMM_ALPHABET_SIZE];
+} bomm_trie_state_t;
+
+/**
+ * Variable-size struct representing a trie compiled into a flat Aho–Corasick
+ * automaton. Every trie node becomes a state (numbered in breadth-first order,
+ * the root being state 0) with a transition for every letter, following the
+ * failure links where the trie has no child. As the output of a state
+ * accumulates the values along its failure links, a message is scored in a
+ * single pass taking one table lookup per letter, giving the same score as
+ * restarting a trie walk at every offset.
+ */
+typedef struct _bomm_trie_automaton {
+    /**
+     * Number of states
+     */
+    unsigned int num_states;
+
+    /**
+     * Largest output of any state, i.e. the most a single letter may add to
+     * the score
+     */
+    double max_output;
+
+    /**
+     * States
+     */
+    bomm_trie_state_t states[];
+} bomm_trie_automaton_t;
+
+/**
+ * Compile the given trie (including garbled variants inserted) into a newly
+ * allocated automaton.
+ * @return Returns NULL on allocation failure.
+ */
+bomm_trie_automaton_t* bomm_trie_automaton_init(const bomm_trie_t* trie);
+
+/**
+ * Score the given letters using the given automaton.
+ */
+static inline double bomm_trie_automaton_measure_letters(
+    const bomm_trie_automaton_t* automaton,
+    const bomm_letter_t* letters,
+    unsigned int length
+) {
+    const bomm_trie_state_t* states = automaton->states;
+    double score = 0;
+    unsigned int state = 0;
+    for (unsigned int index = 0; index < length; index++) {
+        state = states[state].transitions[letters[index]];
+        score += states[state].output;
+    }
+    return score;
+}
+
+/**
+ * Score a message using the given automaton. Matches
+ * `bomm_trie_measure_message` for the trie it has been compiled from up to
+ * rounding.
+ */
+static inline double bomm_trie_automaton_measure_message(
+    const bomm_trie_automaton_t* automaton,
+    const bomm_message_t* message
+) {
+    return bomm_trie_automaton_measure_letters(
+        automaton, message->letters, message->length);
+}
+
+/**
+ * Score a message put through the given scrambler and plugboard using the
+ * given automaton, feeding the scrambler output letters to it directly
+ * instead of materializing the plaintext first.
+ */
+static inline double bomm_trie_automaton_measure_scrambler(
+    const bomm_trie_automaton_t* automaton,
+    const bomm_scrambler_t* scrambler,
+    const bomm_plugboard_t* plugboard,
+    const bomm_message_t* message
+) {
+    const bomm_trie_state_t* states = automaton->states;
+    double score = 0;
+    unsigned int state = 0;
+    unsigned int letter;
+    for (unsigned int index = 0; index < message->length; index++) {
+        letter = message->letters[index];
+        letter = plugboard->map[letter];
+        letter = scrambler->map[index][letter];
+        letter = plugboard->map[letter];
+        state = states[state].transitions[letter];
+        score += states[state].output;
+    }
+    return score;
+}
+
+/**
+ * Bounded variant of `bomm_trie_automaton_measure_scrambler`: Stops as soon
+ * as the score can no longer exceed the given bound, even if every remaining
+ * letter added `max_output`, and returns `-INFINITY` in this case.
+ */
+static inline double bomm_trie_automaton_measure_scrambler_bounded(
+    const bomm_trie_automaton_t* automaton,
+    const bomm_scrambler_t* scrambler,
+    const bomm_plugboard_t* plugboard,
+    const bomm_message_t* message,
+    double bound
+) {
+    const bomm_trie_state_t* states = automaton->states;
+    double max_output = automaton->max_output;
+    unsigned int length = message->length;
+    double score = 0;
+    unsigned int state = 0;
+    unsigned int letter;
+    for (unsigned int index = 0; index < length; index++) {
+        letter = message->letters[index];
+        letter = plugboard->map[letter];
+        letter = scrambler->map[index][letter];
+        letter = plugboard->map[letter];
+        state = states[state].transitions[letter];
+        score += states[state].output;
+        if (score + (double) (length - index - 1) * max_output <= bound) {
+            return -INFINITY;
+        }
+    }
+    return score;
+}
+
 /**
  * Print the contents of the given trie to stdout. Useful for debugging.
  */
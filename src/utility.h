@@ -101,6 +101,42 @@ inline static void* bomm_lookup_string(
     return match;
 }
 
+/**
+ * Calculate the fingerprint (a 64-bit hash) of the given data. Never returns 0,
+ * such that 0 may mark the absence of a fingerprint.
+ * @param seed Seed the hash is initialized with; Used to chain fingerprints
+ */
+static inline unsigned long long bomm_fingerprint(
+    const void* data,
+    size_t size,
+    unsigned long long seed
+) {
+    const unsigned char* bytes = data;
+    unsigned long long hash = seed ^ (size * 0x9e3779b97f4a7c15ULL);
+    unsigned long long word;
+    size_t i = 0;
+
+    // Mix in 8 bytes at a time
+    for (; i + sizeof(word) <= size; i += sizeof(word)) {
+        memcpy(&word, &bytes[i], sizeof(word));
+        hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 32;
+    }
+
+    // Mix in the remaining bytes
+    for (; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+
+    // Final avalanche
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash != 0 ? hash : 1;
+}
+
 /**
  * Shuffle the given array following the Fisher–Yates algorithm.
  */
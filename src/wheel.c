@@ -29,6 +29,24 @@ bomm_wheel_t* bomm_wheel_init(
     return wheel;
 }
 
+void bomm_wheel_offset_maps_init(
+    bomm_wheel_offset_maps_t* offset_maps,
+    const bomm_wheel_t* wheel
+) {
+    unsigned int offset, letter, contact;
+    for (offset = 0; offset < BOMM_ALPHABET_SIZE; offset++) {
+        for (letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+            contact = (letter + offset) % BOMM_ALPHABET_SIZE;
+            offset_maps->map[offset][letter] = (bomm_letter_t)
+                ((wheel->wiring.map[contact] + BOMM_ALPHABET_SIZE - offset) %
+                    BOMM_ALPHABET_SIZE);
+            offset_maps->rev[offset][letter] = (bomm_letter_t)
+                ((wheel->wiring.rev[contact] + BOMM_ALPHABET_SIZE - offset) %
+                    BOMM_ALPHABET_SIZE);
+        }
+    }
+}
+
 bomm_wheel_t* bomm_wheel_init_with_name(bomm_wheel_t* wheel, const char* name) {
     unsigned int index = 0;
     unsigned int num_kown_wheels =
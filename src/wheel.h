@@ -37,6 +37,24 @@ typedef struct _bomm_wheel {
     bomm_lettermask_t turnovers;
 } bomm_wheel_t;
 
+/**
+ * Struct storing the maps of a wheel for each effective offset (position minus
+ * ring setting); Precomputed to avoid modulo arithmetic when scrambling
+ * letters. Kept apart from the wheel itself, as wheels are copied along with
+ * every key.
+ */
+typedef struct _bomm_wheel_offset_maps {
+    /**
+     * Forward map of the wheel for each effective offset
+     */
+    bomm_letter_t map[BOMM_ALPHABET_SIZE][BOMM_ALPHABET_SIZE];
+
+    /**
+     * Reverse map of the wheel for each effective offset
+     */
+    bomm_letter_t rev[BOMM_ALPHABET_SIZE][BOMM_ALPHABET_SIZE];
+} bomm_wheel_offset_maps_t;
+
 /**
  * Struct describing a wheel with strings used to statically store known wheels
  */
@@ -111,6 +129,25 @@ bomm_wheel_t* bomm_wheel_init(
     const char* turnovers_string
 );
 
+/**
+ * Precompute the forward and reverse maps of the given wheel for each
+ * effective offset from its wiring.
+ */
+void bomm_wheel_offset_maps_init(
+    bomm_wheel_offset_maps_t* offset_maps,
+    const bomm_wheel_t* wheel
+);
+
+/**
+ * Return the effective offset (position minus ring setting) of a wheel.
+ */
+static inline unsigned int bomm_wheel_offset(
+    unsigned int position,
+    unsigned int ring
+) {
+    return (unsigned int) bomm_mod((int) position - (int) ring, BOMM_ALPHABET_SIZE);
+}
+
 /**
  * Initialize a known wheel from its name.
  */
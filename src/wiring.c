@@ -60,7 +60,7 @@ bomm_plugboard_t* bomm_plugboard_init_identity(bomm_plugboard_t* plugboard) {
     if (!plugboard && !(plugboard = malloc(sizeof(bomm_plugboard_t)))) {
         return NULL;
     }
-    for (unsigned int i = 0; i < BOMM_ALPHABET_SIZE; i++) {
+    for (unsigned int i = 0; i < BOMM_PLUGBOARD_MAP_SIZE; i++) {
         plugboard->map[i] = i;
     }
     return plugboard;
@@ -96,7 +96,7 @@ bomm_plugboard_t* bomm_plugboard_init(
         b = message->letters[i + 1];
         // Only self-steckered letters may be swapped to form steckered pairs
         valid = valid && plugboard->map[a] == a && plugboard->map[b] == b;
-        bomm_swap(&plugboard->map[a], &plugboard->map[b]);
+        bomm_swap_letter(&plugboard->map[a], &plugboard->map[b]);
     }
     free(message);
 
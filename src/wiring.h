@@ -31,15 +31,23 @@ typedef struct _bomm_wiring {
     bomm_letter_t rev[BOMM_ALPHABET_SIZE];
 } bomm_wiring_t;
 
+/**
+ * Number of letters a plugboard map is padded to, i.e. the alphabet size
+ * rounded up to a multiple of 32, such that the map can be loaded into vector
+ * registers as a whole and used as a byte shuffle table
+ */
+#define BOMM_PLUGBOARD_MAP_SIZE ((BOMM_ALPHABET_SIZE + 31) / 32 * 32)
+
 /**
  * Struct representing a plugboard wiring.
  * Optimized for performance.
  */
 typedef struct _bomm_plugboard {
     /**
-     * Map (forward and backward, as a plugboard wiring is an involution)
+     * Map (forward and backward, as a plugboard wiring is an involution);
+     * Letters past the alphabet (padding) map to themselves.
      */
-    unsigned int map[BOMM_ALPHABET_SIZE];
+    bomm_letter_t map[BOMM_PLUGBOARD_MAP_SIZE];
 } bomm_plugboard_t;
 
 /**
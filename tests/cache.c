@@ -0,0 +1,31 @@
+//
+//  cache.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <criterion/criterion.h>
+#include "../src/cache.h"
+
+Test(cache, bomm_cache_lookup) {
+    bomm_cache_t* cache = bomm_cache_init(NULL, 16);
+    cr_assert_neq(cache, NULL);
+
+    unsigned long long fingerprint = 0x1234;
+    cr_assert_eq(bomm_cache_lookup(cache, fingerprint), NULL);
+
+    bomm_cache_entry_t* entry = bomm_cache_store(cache, fingerprint);
+    entry->scores[0] = 42.0;
+    cr_assert_eq(bomm_cache_lookup(cache, fingerprint), entry);
+    cr_assert_eq(bomm_cache_lookup(cache, fingerprint)->scores[0], 42.0);
+
+    // A fingerprint mapping to the same entry evicts it
+    cr_assert_eq(bomm_cache_store(cache, fingerprint + 16), entry);
+    cr_assert_eq(bomm_cache_lookup(cache, fingerprint), NULL);
+
+    cr_assert_eq(cache->num_lookups, 4);
+    cr_assert_eq(cache->num_hits, 2);
+
+    free(cache);
+}
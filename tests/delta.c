@@ -0,0 +1,197 @@
+//
+//  delta.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <criterion/criterion.h>
+#include "shared/helpers.h"
+#include "../src/delta.h"
+#include "../src/enigma.h"
+#include "../src/utility.h"
+
+#define epsilon 0.000000001
+
+Test(delta, bomm_delta_measure) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_measure_ngram_map_init(2, "./data/frequencies/enigma1941-bigram.txt");
+    bomm_measure_ngram_map_init(3, "./data/frequencies/enigma1941-trigram.txt");
+
+    // Ciphertext spanning more than two position set words
+    bomm_message_t* ciphertext = bomm_message_init(
+        "nczwvusxpnyminhzxmqxsfwxwlkjahshnmcoccakuqpmkcsmhkseinjusblkiosxckub"
+        "hmllxcsjusrrdvkohulxwccbgvliyxeoahxrhkkfvdrewezlxobafgyjqsweqtedjai"
+        "yvqjutqxkyxavxhitlutsunqrtliabftqrnuwlqvnitrsctnqipklmaheefdcabcuwo"
+    );
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(ciphertext->length));
+    scrambler->length = ciphertext->length;
+
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    key.positions[2] = 4;
+    key.positions[3] = 20;
+    bomm_enigma_generate_scrambler(scrambler, &key);
+
+    bomm_measure_t measures[] = {
+        BOMM_MEASURE_SINKOV_BIGRAM,
+        BOMM_MEASURE_SINKOV_TRIGRAM,
+        BOMM_MEASURE_IC,
+        BOMM_MEASURE_IC_BIGRAM,
+        BOMM_MEASURE_ENTROPY,
+        BOMM_MEASURE_ENTROPY_BIGRAM
+    };
+    for (unsigned int m = 0; m < sizeof(measures) / sizeof(measures[0]); m++) {
+        bomm_measure_t measure = measures[m];
+        bomm_plugboard_t plugboard;
+        bomm_plugboard_init_identity(&plugboard);
+
+        bomm_delta_t* delta = bomm_delta_init(
+            NULL, measure, scrambler, &plugboard, ciphertext);
+        cr_assert_neq(delta, NULL);
+        cr_assert_float_eq(
+            bomm_delta_score(delta),
+            bomm_measure_scrambler(measure, scrambler, &plugboard, ciphertext),
+            epsilon
+        );
+
+        // Evaluate and commit to a sequence of plugboard changes
+        unsigned int i, k;
+        for (unsigned int step = 0; step < 200; step++) {
+            i = (step * 7) % BOMM_ALPHABET_SIZE;
+            k = (step * 11 + 3) % BOMM_ALPHABET_SIZE;
+            if (i == k) {
+                continue;
+            }
+
+            bomm_plugboard_t candidate;
+            memcpy(&candidate, &plugboard, sizeof(candidate));
+            unsigned int a = candidate.map[i];
+            unsigned int b = candidate.map[k];
+            candidate.map[a] = a;
+            candidate.map[b] = b;
+            candidate.map[i] = k;
+            candidate.map[k] = i;
+
+            double expected_score = bomm_measure_scrambler(
+                measure, scrambler, &candidate, ciphertext);
+            cr_assert_float_eq(
+                bomm_delta_measure(delta, &candidate),
+                expected_score,
+                epsilon
+            );
+
+            // Measuring is expected not to change the committed state
+            cr_assert_float_eq(
+                bomm_delta_score(delta),
+                bomm_measure_scrambler(measure, scrambler, &plugboard, ciphertext),
+                epsilon
+            );
+
+            if (step % 3 == 0) {
+                memcpy(&plugboard, &candidate, sizeof(plugboard));
+                bomm_delta_commit(delta, &plugboard);
+                cr_assert_float_eq(bomm_delta_score(delta), expected_score, epsilon);
+
+                // Committed scores match exactly, except for entropy
+                if (measure < BOMM_MEASURE_ENTROPY) {
+                    cr_assert_eq(bomm_delta_score(delta), expected_score);
+                }
+            }
+        }
+
+        free(delta);
+    }
+
+    // Sparse maps store the same values as the dense maps
+    bomm_measure_ngram_sparse_init(3, "./data/frequencies/enigma1941-trigram.txt");
+    bomm_plugboard_t plugboard;
+    bomm_plugboard_init_identity(&plugboard);
+    bomm_delta_t* delta = bomm_delta_init(
+        NULL, BOMM_MEASURE_SINKOV_TRIGRAM, scrambler, &plugboard, ciphertext);
+    cr_assert_neq(delta, NULL);
+    cr_assert_eq(delta->source, BOMM_NGRAM_SOURCE_SPARSE);
+    plugboard.map[0] = 4;
+    plugboard.map[4] = 0;
+    cr_assert_float_eq(
+        bomm_delta_measure(delta, &plugboard),
+        bomm_measure_scrambler(BOMM_MEASURE_SINKOV_TRIGRAM, scrambler, &plugboard, ciphertext),
+        epsilon
+    );
+    bomm_delta_commit(delta, &plugboard);
+    cr_assert_eq(
+        bomm_delta_score(delta),
+        bomm_measure_scrambler(BOMM_MEASURE_SINKOV_TRIGRAM, scrambler, &plugboard, ciphertext)
+    );
+    free(delta);
+
+    // Histograms of higher order n-grams are not supported
+    cr_assert_eq(
+        bomm_delta_init(NULL, BOMM_MEASURE_IC_TRIGRAM, scrambler, &key.plugboard, ciphertext),
+        NULL
+    );
+    cr_assert_eq(
+        bomm_delta_init(NULL, BOMM_MEASURE_TRIE, scrambler, &key.plugboard, ciphertext),
+        NULL
+    );
+
+    free(scrambler);
+    free(ciphertext);
+    bomm_measure_config_destroy();
+}
+
+Test(delta, bomm_delta_measure_quantized) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_measure_ngram_map_init(3, "./data/frequencies/enigma1941-trigram.txt");
+    bomm_measure_ngram_qmap_init(3, BOMM_NGRAM_QUANTIZATION_INT8);
+
+    bomm_message_t* ciphertext = bomm_message_init(
+        "nczwvusxpnyminhzxmqxsfwxwlkjahshnmcoccakuqpmkcsmhkseinjusblkiosxckub"
+        "hmllxcsjusrrdvkohulxwccbgvliyxeoahxrhkkfvdrewezlxobafgyjqsweqtedjai"
+    );
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(ciphertext->length));
+    scrambler->length = ciphertext->length;
+
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    bomm_enigma_generate_scrambler(scrambler, &key);
+
+    bomm_plugboard_t plugboard;
+    bomm_plugboard_init_identity(&plugboard);
+    bomm_delta_t* delta = bomm_delta_init(
+        NULL, BOMM_MEASURE_SINKOV_TRIGRAM, scrambler, &plugboard, ciphertext);
+    cr_assert_neq(delta, NULL);
+
+    // Levels are accumulated exactly, thus scores match the full measure
+    for (unsigned int step = 0; step < 100; step++) {
+        unsigned int i = (step * 5) % BOMM_ALPHABET_SIZE;
+        unsigned int k = (step * 3 + 1) % BOMM_ALPHABET_SIZE;
+        if (i == k || plugboard.map[i] != i || plugboard.map[k] != k) {
+            continue;
+        }
+
+        bomm_plugboard_t candidate;
+        memcpy(&candidate, &plugboard, sizeof(candidate));
+        candidate.map[i] = k;
+        candidate.map[k] = i;
+
+        double expected_score = bomm_measure_scrambler(
+            BOMM_MEASURE_SINKOV_TRIGRAM, scrambler, &candidate, ciphertext);
+        cr_assert_eq(bomm_delta_measure(delta, &candidate), expected_score);
+
+        if (step % 4 == 0) {
+            memcpy(&plugboard, &candidate, sizeof(plugboard));
+            bomm_delta_commit(delta, &plugboard);
+            cr_assert_eq(bomm_delta_score(delta), expected_score);
+        }
+    }
+
+    free(delta);
+    free(scrambler);
+    free(ciphertext);
+    bomm_measure_config_destroy();
+}
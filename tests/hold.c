@@ -95,3 +95,78 @@ Test(key, bomm_hold_add) {
 
     bomm_hold_destroy(hold);
 }
+
+/**
+ * Export unsigned integer hold element data to JSON.
+ */
+static json_t* _test_hold_serialize(const void* data) {
+    return json_integer(*((const unsigned int*) data));
+}
+
+/**
+ * Import unsigned integer hold element data from JSON.
+ */
+static bool _test_hold_deserialize(void* data, json_t* data_json) {
+    if (!json_is_integer(data_json)) {
+        return false;
+    }
+    *((unsigned int*) data) = (unsigned int) json_integer_value(data_json);
+    return true;
+}
+
+Test(hold, bomm_hold_add_json) {
+    size_t element_size = sizeof(unsigned int);
+    unsigned int data;
+    bomm_hold_element_t* element;
+
+    bomm_hold_t* hold = bomm_hold_init(NULL, element_size, 3);
+    data = 1337;
+    bomm_hold_add(hold, 3, &data, "L333t");
+    data = 7777;
+    bomm_hold_add(hold, -0.125, &data, "7777");
+
+    json_t* hold_json = bomm_hold_to_json(hold, _test_hold_serialize);
+    cr_assert_neq(hold_json, NULL);
+    cr_assert_eq(json_integer_value(json_object_get(hold_json, "size")), 3);
+    cr_assert_eq(json_array_size(json_object_get(hold_json, "elements")), 2);
+    json_t* data_json = json_object_get(
+        json_array_get(json_object_get(hold_json, "elements"), 0), "data");
+    cr_assert_eq(json_integer_value(data_json), 1337);
+
+    // Elements of another hold are merged and duplicates ignored
+    bomm_hold_t* other_hold = bomm_hold_init(NULL, element_size, 3);
+    data = 4444;
+    bomm_hold_add(other_hold, 4, &data, "<4");
+    data = 1337;
+    bomm_hold_add(other_hold, 3, &data, "L333t");
+    cr_assert(bomm_hold_add_json(other_hold, hold_json, _test_hold_deserialize));
+    cr_assert_eq(other_hold->num_elements, 3);
+
+    element = bomm_hold_at(other_hold, 0);
+    cr_assert_eq(element->score, 4);
+    cr_assert_eq(*((unsigned int*) element->data), 4444);
+
+    element = bomm_hold_at(other_hold, 1);
+    cr_assert_eq(element->score, 3);
+    cr_assert_eq(*((unsigned int*) element->data), 1337);
+
+    element = bomm_hold_at(other_hold, 2);
+    cr_assert_eq(element->score, -0.125);
+    cr_assert_eq(*((unsigned int*) element->data), 7777);
+    cr_assert_str_eq(element->preview, "7777");
+
+    // Elements with data the deserializer rejects are invalid
+    bomm_hold_t* invalid_hold = bomm_hold_init(NULL, element_size, 3);
+    json_object_set_new(
+        json_array_get(json_object_get(hold_json, "elements"), 0),
+        "data",
+        json_string("1337")
+    );
+    cr_assert_not(bomm_hold_add_json(invalid_hold, hold_json, _test_hold_deserialize));
+    cr_assert_eq(invalid_hold->num_elements, 0);
+
+    json_decref(hold_json);
+    bomm_hold_destroy(invalid_hold);
+    bomm_hold_destroy(other_hold);
+    bomm_hold_destroy(hold);
+}
@@ -6,7 +6,9 @@
 //
 
 #include <criterion/criterion.h>
+#include <limits.h>
 #include "shared/helpers.h"
+#include "../src/enigma.h"
 #include "../src/key.h"
 
 Test(key, bomm_key_mechanism_from_string) {
@@ -63,7 +65,7 @@ Test(key, bomm_key_iterator_next) {
         num_keys++;
     }
 
-    cr_assert_eq(num_keys, 27418560);
+    cr_assert_eq(num_keys, 26404560);
     cr_assert_arr_eq(&key_iterator, &expected_key_iterator, sizeof(key_iterator));
 }
 
@@ -147,16 +149,296 @@ Test(key, bomm_key_space_count) {
     bomm_key_space_init_enigma_i(&key_space);
 
     key_space.plug_mask = BOMM_LETTERMASK_NONE;
-    cr_assert_eq(bomm_key_space_count(&key_space), 27418560);
+    cr_assert_eq(bomm_key_space_count(&key_space), 26404560);
     
     key_space.plug_mask = 0x10;
-    cr_assert_eq(bomm_key_space_count(&key_space), 712882560);
+    cr_assert_eq(bomm_key_space_count(&key_space), 686518560);
 
     key_space.plug_mask = 0x862110;
-    cr_assert_eq(bomm_key_space_count(&key_space), 3728924160);
+    cr_assert_eq(bomm_key_space_count(&key_space), 3591020160);
 
     key_space.plug_mask = BOMM_LETTERMASK_ALL;
-    cr_assert_eq(bomm_key_space_count(&key_space), 8938450560);
+    cr_assert_eq(bomm_key_space_count(&key_space), 8607886560);
+}
+
+/**
+ * Assert that every redundant key in the given key space is equivalent to a
+ * key that is not redundant and that the key space count matches the number
+ * of keys that are not redundant.
+ * @return Number of redundant keys
+ */
+unsigned long _assert_redundant_keys_equivalent(
+    const bomm_key_space_t* key_space,
+    unsigned int length
+) {
+    // Enumerate all keys including redundant ones using a mechanism without
+    // equivalences
+    bomm_key_space_t raw_key_space;
+    memcpy(&raw_key_space, key_space, sizeof(raw_key_space));
+    raw_key_space.mechanism = BOMM_MECHANISM_ODOMETER;
+    raw_key_space.message_length = 0;
+
+    size_t scrambler_size = length * BOMM_ALPHABET_SIZE;
+    unsigned long max_num_keys = bomm_key_space_count(&raw_key_space);
+    bomm_letter_t* canonical_maps = malloc(max_num_keys * scrambler_size);
+    bomm_letter_t* redundant_maps = malloc(max_num_keys * scrambler_size);
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(length));
+    scrambler->length = length;
+
+    unsigned long num_canonical_keys = 0;
+    unsigned long num_redundant_keys = 0;
+    bomm_key_iterator_t key_iterator;
+    cr_assert_neq(bomm_key_iterator_init(&key_iterator, &raw_key_space), NULL);
+    do {
+        bomm_key_t key;
+        memcpy(&key, &key_iterator.key, sizeof(key));
+        key.mechanism = BOMM_MECHANISM_STEPPING;
+        key.fast_wheel_slot = 3;
+        bomm_enigma_generate_scrambler(scrambler, &key);
+        if (bomm_key_is_redundant(&key, key_space)) {
+            memcpy(
+                &redundant_maps[num_redundant_keys++ * scrambler_size],
+                scrambler->map,
+                scrambler_size
+            );
+        } else {
+            memcpy(
+                &canonical_maps[num_canonical_keys++ * scrambler_size],
+                scrambler->map,
+                scrambler_size
+            );
+        }
+    } while (!bomm_key_iterator_next(&key_iterator));
+
+    cr_assert_eq(num_canonical_keys + num_redundant_keys, max_num_keys);
+    cr_assert_eq(bomm_key_space_count(key_space), num_canonical_keys);
+
+    // Every redundant key is expected to be equivalent to a canonical key
+    for (unsigned long i = 0; i < num_redundant_keys; i++) {
+        bool found = false;
+        for (unsigned long j = 0; !found && j < num_canonical_keys; j++) {
+            found = memcmp(
+                &redundant_maps[i * scrambler_size],
+                &canonical_maps[j * scrambler_size],
+                scrambler_size
+            ) == 0;
+        }
+        cr_assert(found, "Redundant key %lu has no canonical equivalent", i);
+    }
+
+    free(scrambler);
+    free(redundant_maps);
+    free(canonical_maps);
+    return num_redundant_keys;
+}
+
+Test(key, bomm_key_is_redundant) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    key_space.wheel_sets[1][1].name[0] = '\0';
+    key_space.wheel_sets[2][0] = key_space.wheel_sets[2][1];
+    key_space.wheel_sets[2][1].name[0] = '\0';
+    key_space.wheel_sets[3][0] = key_space.wheel_sets[3][2];
+    key_space.wheel_sets[3][1].name[0] = '\0';
+    key_space.ring_masks[1] = 0x2000007;
+    key_space.ring_masks[3] = BOMM_LETTERMASK_FIRST;
+    key_space.position_masks[1] = 0x3ffff00;
+    key_space.position_masks[3] = 0x3e00007;
+
+    unsigned long num_keys = 4 * 18 * 26 * 8;
+    cr_assert_gt(_assert_redundant_keys_equivalent(&key_space, 12), num_keys / 2);
+}
+
+Test(key, bomm_key_is_redundant_message_length) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    key_space.wheel_sets[1][1].name[0] = '\0';
+    key_space.wheel_sets[2][0] = key_space.wheel_sets[2][1];
+    key_space.wheel_sets[2][1].name[0] = '\0';
+    key_space.wheel_sets[3][0] = key_space.wheel_sets[3][4];
+    key_space.wheel_sets[3][1].name[0] = '\0';
+    key_space.ring_masks[2] = 0x3;
+    key_space.ring_masks[3] = BOMM_LETTERMASK_ALL;
+    key_space.position_masks[1] = BOMM_LETTERMASK_FIRST;
+    key_space.position_masks[2] = 0x1c0038;
+    key_space.position_masks[3] = BOMM_LETTERMASK_ALL;
+
+    unsigned long num_keys = 2 * 6 * 26 * 26;
+    key_space.message_length = 14;
+    unsigned long num_redundant_keys =
+        _assert_redundant_keys_equivalent(&key_space, 14);
+    cr_assert_gt(num_redundant_keys, num_keys / 2);
+
+    // Longer messages reach all turnover phases of the fast wheel
+    key_space.message_length = 40;
+    cr_assert_lt(
+        _assert_redundant_keys_equivalent(&key_space, 40),
+        num_redundant_keys
+    );
+}
+
+/**
+ * Assert that unranking, ranking, and seeking match iterating the given key
+ * space key by key.
+ * @return Number of keys
+ */
+unsigned long _assert_key_space_ranks(const bomm_key_space_t* key_space) {
+    unsigned int num_slots = key_space->num_slots;
+    unsigned long num_keys = bomm_key_space_count(key_space);
+    bomm_key_iterator_t key_iterator;
+    bomm_key_iterator_t seek_iterator;
+    cr_assert_neq(bomm_key_iterator_init(&key_iterator, key_space), NULL);
+    cr_assert_neq(bomm_key_iterator_init(&seek_iterator, key_space), NULL);
+
+    unsigned long index = 0;
+    do {
+        bomm_key_t key;
+        cr_assert_neq(bomm_key_space_unrank(key_space, index, &key), NULL);
+        cr_assert_eq(
+            memcmp(&key, &key_iterator.key, sizeof(bomm_key_t)),
+            0,
+            "Unranked key at index %lu does not match the iterator",
+            index
+        );
+
+        unsigned long rank;
+        cr_assert(bomm_key_space_rank(key_space, &key_iterator.key, &rank));
+        cr_assert_eq(rank, index);
+
+        // The iterator state is expected to match, such that iterating
+        // continues identically after seeking
+        cr_assert_not(bomm_key_iterator_seek(&seek_iterator, index));
+        cr_assert_eq(seek_iterator.index, index);
+        cr_assert(seek_iterator.scrambler_changed);
+        cr_assert_arr_eq(
+            seek_iterator.ring_masks,
+            key_iterator.ring_masks,
+            num_slots * sizeof(bomm_lettermask_t)
+        );
+        cr_assert_arr_eq(
+            seek_iterator.position_masks,
+            key_iterator.position_masks,
+            num_slots * sizeof(bomm_lettermask_t)
+        );
+        cr_assert_arr_eq(
+            seek_iterator.solo_plug,
+            key_iterator.solo_plug,
+            sizeof(key_iterator.solo_plug)
+        );
+        index++;
+    } while (!bomm_key_iterator_next(&key_iterator));
+
+    cr_assert_eq(index, num_keys);
+    cr_assert_eq(bomm_key_space_unrank(key_space, num_keys, NULL), NULL);
+    cr_assert(bomm_key_iterator_seek(&seek_iterator, num_keys));
+    return num_keys;
+}
+
+Test(key, bomm_key_space_unrank) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    key_space.wheel_sets[1][2].name[0] = '\0';
+    key_space.wheel_sets[2][3].name[0] = '\0';
+    key_space.wheel_sets[3][0] = key_space.wheel_sets[3][2];
+    key_space.wheel_sets[3][1] = key_space.wheel_sets[3][4];
+    key_space.wheel_sets[3][2].name[0] = '\0';
+    key_space.ring_masks[1] = 0x2000007;
+    key_space.ring_masks[2] = 0x3;
+    key_space.ring_masks[3] = 0x3;
+    key_space.position_masks[1] = 0x2000003;
+    key_space.position_masks[2] = 0x1c0039;
+    key_space.position_masks[3] = 0x300001f;
+
+    // Stepping mechanism with double stepping and ring setting equivalences
+    cr_assert_gt(_assert_key_space_ranks(&key_space), 1000);
+
+    // Offset space enumeration
+    key_space.message_length = 14;
+    cr_assert_gt(_assert_key_space_ranks(&key_space), 1000);
+
+    // Offset and limit
+    key_space.offset = 234;
+    key_space.limit = 567;
+    cr_assert_eq(_assert_key_space_ranks(&key_space), 567);
+
+    // Mechanism without equivalences
+    key_space.offset = 0;
+    key_space.limit = LONG_MAX;
+    key_space.mechanism = BOMM_MECHANISM_ODOMETER;
+    key_space.message_length = 0;
+    cr_assert_gt(_assert_key_space_ranks(&key_space), 1000);
+
+    // Solo plugs skipping letters steckered in the key space plugboard
+    key_space.mechanism = BOMM_MECHANISM_STEPPING;
+    key_space.position_masks[1] = 0x3;
+    key_space.position_masks[2] = 0x3;
+    key_space.position_masks[3] = 0x3;
+    key_space.plug_mask = 0x11;
+    bomm_plugboard_init(&key_space.plugboard, "ab");
+    cr_assert_gt(_assert_key_space_ranks(&key_space), 1000);
+}
+
+Test(key, bomm_key_space_rank_invalid) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    unsigned long index;
+
+    bomm_key_space_unrank(&key_space, 123456, &key);
+    cr_assert(bomm_key_space_rank(&key_space, &key, &index));
+    cr_assert_eq(index, 123456);
+
+    // Keys outside the masks or being redundant are not ranked
+    bomm_lettermask_clear(&key_space.position_masks[3], key.positions[3]);
+    cr_assert_not(bomm_key_space_rank(&key_space, &key, &index));
+    bomm_key_space_init_enigma_i(&key_space);
+    key.rings[1] = 1;
+    cr_assert_not(bomm_key_space_rank(&key_space, &key, &index));
+}
+
+Test(key, bomm_key_to_json) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    memcpy(&key.wheels[1], &key_space.wheel_sets[1][4], sizeof(bomm_wheel_t));
+    memcpy(&key.wheels[3], &key_space.wheel_sets[3][1], sizeof(bomm_wheel_t));
+    key.rings[3] = 7;
+    key.positions[1] = 25;
+    key.positions[2] = 4;
+    bomm_plugboard_init(&key.plugboard, "ab yz");
+
+    // Known wheels are referenced by name
+    json_t* key_json = bomm_key_to_json(&key);
+    cr_assert_neq(key_json, NULL);
+    json_t* slot_json = json_array_get(json_object_get(key_json, "slots"), 3);
+    cr_assert_str_eq(json_string_value(json_object_get(slot_json, "wheel")), "II");
+    cr_assert_str_eq(json_string_value(json_object_get(slot_json, "ring")), "h");
+    cr_assert_str_eq(json_string_value(json_object_get(key_json, "plugboard")), "ab yz");
+
+    // Importing the fields yields the same key byte by byte
+    bomm_key_t actual_key;
+    cr_assert_eq(bomm_key_init_with_json(&actual_key, key_json), &actual_key);
+    cr_assert_arr_eq(&actual_key, &key, sizeof(bomm_key_t));
+    json_decref(key_json);
+
+    // Custom wheels are described by their wiring and turnovers
+    bomm_wheel_init(&key.wheels[4], "ETW-ABC", "bacdefghijklmnopqrstuvwxyz", "q");
+    key_json = bomm_key_to_json(&key);
+    slot_json = json_array_get(json_object_get(key_json, "slots"), 4);
+    cr_assert(json_is_object(json_object_get(slot_json, "wheel")));
+    cr_assert_eq(bomm_key_init_with_json(&actual_key, key_json), &actual_key);
+    cr_assert_arr_eq(&actual_key, &key, sizeof(bomm_key_t));
+
+    // Unknown wheels are rejected
+    json_object_set_new(slot_json, "wheel", json_string("IX"));
+    cr_assert_eq(bomm_key_init_with_json(&actual_key, key_json), NULL);
+    json_decref(key_json);
 }
 
 Test(key, bomm_key_space_slice) {
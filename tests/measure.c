@@ -7,7 +7,10 @@
 
 #include <criterion/criterion.h>
 #include "shared/helpers.h"
+#include "../src/enigma.h"
 #include "../src/measure.h"
+#include "../src/simd.h"
+#include "../src/utility.h"
 
 #define epsilon 0.00000000000000000001
 
@@ -129,8 +132,7 @@ Test(measure, bomm_measure_ngram_map_init) {
         epsilon
     );
 
-    free(trigram_map);
-
+    // Initializing another map replaces (and frees) the previous one
     trigram_map = bomm_measure_ngram_map_init(3, "./data/frequencies/en-trigram.txt");
 
     // Testing a top frequency: THE (19 7 4)
@@ -151,5 +153,535 @@ Test(measure, bomm_measure_ngram_map_init) {
         epsilon
     );
 
-    free(trigram_map);
+    bomm_measure_config_destroy();
+}
+
+Test(measure, bomm_measure_ngram_map_save) {
+    bomm_test_skip_if_non_latin_alphabet;
+    const char* filename = "./build/tests/enigma1941-trigram.bin";
+    size_t size = sizeof(bomm_ngram_map_t) + 26 * 26 * 26 * sizeof(bomm_ngram_map_entry);
+    bomm_ngram_map_t* expected_map = malloc(size);
+    memcpy(
+        expected_map,
+        bomm_measure_ngram_map_init(3, "./data/frequencies/enigma1941-trigram.txt"),
+        size
+    );
+    cr_assert_lt(expected_map->fallback, expected_map->map[13 * 26 * 26]);
+    size_t strided_size = 32 * 32 * 32 * sizeof(bomm_ngram_map_entry);
+    bomm_ngram_map_entry* expected_strided = malloc(strided_size);
+    memcpy(expected_strided, bomm_ngram_strided[3], strided_size);
+
+    // Converting the text file and mapping the result yields the same map
+    cr_assert(bomm_measure_ngram_map_convert(
+        3, "./data/frequencies/enigma1941-trigram.txt", filename));
+    bomm_ngram_map_t* actual_map = bomm_measure_ngram_map_init(3, filename);
+    cr_assert_neq(actual_map, NULL);
+    cr_assert_eq(bomm_ngram_map[3], actual_map);
+    cr_assert_arr_eq(actual_map, expected_map, size);
+    cr_assert(bomm_measure_ngram_map_verify(3, filename));
+
+    // The strided map is mapped along with the map rather than copied
+    cr_assert_gt((void*) bomm_ngram_strided[3], (void*) actual_map);
+    cr_assert_lt(
+        (unsigned char*) bomm_ngram_strided[3],
+        (unsigned char*) actual_map + size + 64);
+    cr_assert_eq((uintptr_t) bomm_ngram_strided[3] % 64, 0);
+    cr_assert_arr_eq(bomm_ngram_strided[3], expected_strided, strided_size);
+
+    // The largest log probability is read from the header
+    double expected_max = expected_map->fallback;
+    for (unsigned int i = 0; i < 26 * 26 * 26; i++) {
+        if (expected_map->map[i] > expected_max) {
+            expected_max = expected_map->map[i];
+        }
+    }
+    cr_assert_eq(bomm_ngram_max[3], expected_max);
+
+    // Measures read from the mapped file
+    bomm_message_t* message = bomm_message_init("ein");
+    cr_assert_eq(
+        bomm_measure_message(BOMM_MEASURE_SINKOV_TRIGRAM, message),
+        expected_map->map[4 * 26 * 26 + 8 * 26 + 13]
+    );
+    free(message);
+
+    // Files are validated against the requested n on load and against their
+    // checksum on request only
+    cr_assert_eq(bomm_measure_ngram_map_init(2, filename), NULL);
+    cr_assert_eq(bomm_measure_ngram_map_verify(2, filename), false);
+    FILE* file = fopen(filename, "r+b");
+    fseek(file, sizeof(bomm_ngram_map_header_t) + size / 2, SEEK_SET);
+    fputc(0x55, file);
+    fclose(file);
+    cr_assert_eq(bomm_measure_ngram_map_verify(3, filename), false);
+    cr_assert_neq(bomm_measure_ngram_map_init(3, filename), NULL);
+
+    remove(filename);
+    free(expected_map);
+    free(expected_strided);
+    bomm_measure_config_destroy();
+}
+
+Test(measure, bomm_measure_scrambler_function) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_measure_ngram_map_init(2, "./data/frequencies/enigma1941-bigram.txt");
+    bomm_measure_ngram_map_init(3, "./data/frequencies/enigma1941-trigram.txt");
+
+    bomm_message_t* ciphertext = bomm_message_init(
+        "nczwvusxpnyminhzxmqxsfwxwlkjahshnmcoccakuqpmkcsmhkseinjusblkiosxckubhmllxcsjusrrdvkohulxwccbgvliyxeoahxrhkkfvdrewezlxobafgyjqsweqtedjaiyvqjutqxkyxavx"
+    );
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(ciphertext->length));
+    scrambler->length = ciphertext->length;
+
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    key.positions[2] = 4;
+    key.positions[3] = 20;
+    bomm_enigma_generate_scrambler(scrambler, &key);
+    bomm_swap_letter(&key.plugboard.map[0], &key.plugboard.map[4]);
+    bomm_swap_letter(&key.plugboard.map[13], &key.plugboard.map[25]);
+
+    // Specialized functions are expected to agree with the generic measure;
+    // Vectorized Sinkov measures sum up values in a different order and thus
+    // only match up to rounding
+    bomm_measure_t measures[] = {
+        BOMM_MEASURE_SINKOV_BIGRAM,
+        BOMM_MEASURE_SINKOV_TRIGRAM,
+        BOMM_MEASURE_IC,
+        BOMM_MEASURE_IC_BIGRAM,
+        BOMM_MEASURE_ENTROPY,
+        BOMM_MEASURE_ENTROPY_TRIGRAM,
+        BOMM_MEASURE_NONE
+    };
+    for (unsigned int i = 0; i < sizeof(measures) / sizeof(measures[0]); i++) {
+        bomm_measure_scrambler_function_t function =
+            bomm_measure_scrambler_function(measures[i]);
+        double score = function(scrambler, &key.plugboard, ciphertext);
+        double expected_score = bomm_measure_scrambler(
+            measures[i], scrambler, &key.plugboard, ciphertext);
+        if (measures[i] < BOMM_MEASURE_IC) {
+            cr_assert_float_eq(score, expected_score, 0.000000001);
+        } else {
+            cr_assert_eq(score, expected_score);
+        }
+    }
+
+    free(scrambler);
+    free(ciphertext);
+    bomm_measure_config_destroy();
+}
+
+Test(measure, bomm_measure_scrambler_bounded_function) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_measure_ngram_map_init(3, "./data/frequencies/enigma1941-trigram.txt");
+    cr_assert_lt(bomm_ngram_max[3], 0);
+
+    bomm_message_t* ciphertext = bomm_message_init(
+        "nczwvusxpnyminhzxmqxsfwxwlkjahshnmcoccakuqpmkcsmhkseinjusblkiosxckubhmllxcsjusrrdvkohulxwccbgvliyxeoahxrhkkfvdrewezlxobafgyjqsweqtedjaiyvqjutqxkyxavx"
+    );
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(ciphertext->length));
+    scrambler->length = ciphertext->length;
+
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    key.positions[2] = 4;
+    key.positions[3] = 20;
+    bomm_enigma_generate_scrambler(scrambler, &key);
+
+    cr_assert_eq(bomm_measure_scrambler_bounded_function(BOMM_MEASURE_IC), NULL);
+    bomm_measure_scrambler_bounded_function_t function =
+        bomm_measure_scrambler_bounded_function(BOMM_MEASURE_SINKOV_TRIGRAM);
+    cr_assert_neq(function, NULL);
+
+    for (unsigned int quantized = 0; quantized <= 1; quantized++) {
+        bomm_measure_ngram_qmap_init(3, quantized
+            ? BOMM_NGRAM_QUANTIZATION_INT16
+            : BOMM_NGRAM_QUANTIZATION_NONE);
+        for (unsigned int i = 0; i < BOMM_ALPHABET_SIZE; i++) {
+            bomm_swap_letter(
+                &key.plugboard.map[i],
+                &key.plugboard.map[(i * 7 + 3) % BOMM_ALPHABET_SIZE]);
+            double expected_score = bomm_measure_scrambler(
+                BOMM_MEASURE_SINKOV_TRIGRAM, scrambler, &key.plugboard, ciphertext);
+
+            // Measurements exceeding the bound are taken in full
+            cr_assert_eq(
+                function(scrambler, &key.plugboard, ciphertext, expected_score - 0.01),
+                expected_score
+            );
+
+            // Others may be aborted
+            double score = function(
+                scrambler, &key.plugboard, ciphertext, expected_score + 0.01);
+            cr_assert(score == BOMM_MEASURE_ABORTED || score == expected_score);
+            cr_assert_eq(
+                function(scrambler, &key.plugboard, ciphertext, expected_score + 10),
+                BOMM_MEASURE_ABORTED
+            );
+        }
+    }
+
+    free(scrambler);
+    free(ciphertext);
+    bomm_measure_config_destroy();
+}
+
+Test(measure, bomm_measure_ngrams) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_message_t* message = bomm_message_init(
+        "dasoberkommandoderwehrmachtgibtbekanntaachenistgerettetdurchgebuendelte"
+        "neinsatzderhilfskraeftekonntediebedrohungabgewendetunddierettungder"
+        "stadtgegenxeinsxaqtxachtxuhrsichergestelltwerdenxoberkommando"
+    );
+
+    // The sparse variants are expected to match the histogram based ones
+    unsigned int frequencies[BOMM_ALPHABET_SIZE * BOMM_ALPHABET_SIZE * BOMM_ALPHABET_SIZE];
+    unsigned int ngrams[message->length];
+    unsigned int num_ngrams;
+
+    bomm_measure_message_frequency(3, frequencies, message);
+    num_ngrams = bomm_measure_message_ngrams(3, ngrams, message);
+    cr_assert_eq(num_ngrams, message->length - 2);
+    cr_assert_eq(
+        bomm_measure_ngrams_ic(3, ngrams, num_ngrams),
+        bomm_measure_frequency_ic(3, frequencies)
+    );
+    num_ngrams = bomm_measure_message_ngrams(3, ngrams, message);
+    cr_assert_eq(
+        bomm_measure_ngrams_entropy(ngrams, num_ngrams),
+        bomm_measure_frequency_entropy(3, frequencies)
+    );
+    cr_assert_eq(
+        bomm_measure_message(BOMM_MEASURE_IC_TRIGRAM, message),
+        bomm_measure_frequency_ic(3, frequencies)
+    );
+    cr_assert_eq(
+        bomm_measure_message(BOMM_MEASURE_ENTROPY_TRIGRAM, message),
+        bomm_measure_frequency_entropy(3, frequencies)
+    );
+
+    // Hexagram indices are expected to not overflow
+    num_ngrams = bomm_measure_message_ngrams(6, ngrams, message);
+    cr_assert_eq(num_ngrams, message->length - 5);
+    cr_assert_eq(ngrams[0], ((((3 * 26 + 0) * 26 + 18) * 26 + 14) * 26 + 1) * 26 + 4);
+    for (unsigned int i = 0; i < num_ngrams; i++) {
+        cr_assert_lt(ngrams[i], bomm_pow_map[6]);
+    }
+
+    // Higher order measures no longer need a histogram of size 26^n
+    cr_assert_gt(bomm_measure_message(BOMM_MEASURE_IC_HEXAGRAM, message), 0.0);
+    cr_assert_gt(bomm_measure_message(BOMM_MEASURE_ENTROPY_HEXAGRAM, message), 0.0);
+
+    free(message);
+}
+
+Test(measure, bomm_measure_ngram_qmap_init) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_measure_ngram_map_init(3, "./data/frequencies/enigma1941-trigram.txt");
+    bomm_message_t* message = bomm_message_init(
+        "vonvonjlooksjhffttteinseinsdreizwoyyqnnsneuninhaltxx");
+
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(message->length));
+    scrambler->length = message->length;
+    bomm_enigma_generate_scrambler(scrambler, &key);
+    bomm_plugboard_t plugboard;
+    bomm_plugboard_init_identity(&plugboard);
+
+    double message_score = bomm_measure_message_sinkov(3, message);
+    double scrambler_score =
+        bomm_measure_scrambler_sinkov(3, scrambler, &plugboard, message);
+
+    bomm_ngram_quantization_t quantizations[] = {
+        BOMM_NGRAM_QUANTIZATION_INT16,
+        BOMM_NGRAM_QUANTIZATION_INT8
+    };
+    double previous_max_error = 0;
+    for (unsigned int i = 0; i < 2; i++) {
+        cr_assert(bomm_measure_ngram_qmap_init(3, quantizations[i]));
+        bomm_ngram_qmap_t* qmap = bomm_ngram_qmap[3];
+        cr_assert_neq(qmap, NULL);
+        cr_assert_eq(qmap->quantization, quantizations[i]);
+
+        // Rounding to the nearest level errs by half a level at most
+        cr_assert_leq(qmap->max_error, qmap->scale * 0.5 + 1e-9);
+        cr_assert_leq(qmap->mean_error, qmap->max_error);
+        cr_assert_gt(qmap->max_error, previous_max_error);
+        previous_max_error = qmap->max_error;
+
+        // Scores stay within the maximum error of the float scores
+        cr_assert_float_eq(
+            bomm_measure_message_sinkov(3, message),
+            message_score,
+            qmap->max_error
+        );
+        cr_assert_float_eq(
+            bomm_measure_scrambler_sinkov(3, scrambler, &plugboard, message),
+            scrambler_score,
+            qmap->max_error
+        );
+    }
+
+    // Reverting to the float map
+    cr_assert(bomm_measure_ngram_qmap_init(3, BOMM_NGRAM_QUANTIZATION_NONE));
+    cr_assert_eq(bomm_ngram_qmap[3], NULL);
+    cr_assert_eq(bomm_measure_message_sinkov(3, message), message_score);
+
+    // Quantizing requires the map to be loaded
+    cr_assert_not(bomm_measure_ngram_qmap_init(4, BOMM_NGRAM_QUANTIZATION_INT8));
+
+    free(scrambler);
+    free(message);
+    bomm_measure_config_destroy();
+}
+
+Test(measure, bomm_measure_ngram_sparse_init) {
+    bomm_test_skip_if_non_latin_alphabet;
+    const char* filename = "./data/frequencies/enigma1941-trigram.txt";
+    size_t size = sizeof(bomm_ngram_map_t) + 26 * 26 * 26 * sizeof(bomm_ngram_map_entry);
+    bomm_ngram_map_t* dense_map = malloc(size);
+    memcpy(dense_map, bomm_measure_ngram_map_init(3, filename), size);
+    bomm_message_t* message = bomm_message_init(
+        "vonvonjlooksjhffttteinseinsdreizwoyyqnnsneuninhaltxx");
+    double dense_score = bomm_measure_message_sinkov(3, message);
+
+    // The sparse map replaces the dense map and stores the same values
+    bomm_sparse_t* sparse = bomm_measure_ngram_sparse_init(3, filename);
+    cr_assert_neq(sparse, NULL);
+    cr_assert_eq(bomm_ngram_sparse[3], sparse);
+    cr_assert_eq(bomm_ngram_map[3], NULL);
+    cr_assert_eq(bomm_ngram_source(3), BOMM_NGRAM_SOURCE_SPARSE);
+    cr_assert_eq(sparse->fallback, dense_map->fallback);
+    for (unsigned int i = 0; i < 26 * 26 * 26; i++) {
+        cr_assert_eq(bomm_sparse_lookup(sparse, i), dense_map->map[i]);
+    }
+    cr_assert_eq(bomm_measure_message_sinkov(3, message), dense_score);
+
+    // Text files below the pentagram are loaded into dense maps
+    cr_assert(bomm_measure_ngram_model_init(3, filename));
+    cr_assert_eq(bomm_ngram_sparse[3], NULL);
+    cr_assert_neq(bomm_ngram_map[3], NULL);
+
+    free(message);
+    free(dense_map);
+    bomm_measure_config_destroy();
+}
+
+Test(measure, bomm_ngram_strided) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_ngram_map_t* trigram_map = bomm_measure_ngram_map_init(
+        3, "./data/frequencies/enigma1941-trigram.txt");
+    bomm_ngram_map_entry* strided = bomm_ngram_strided[3];
+    cr_assert_neq(strided, NULL);
+    cr_assert_eq((uintptr_t) strided % 64, 0);
+    cr_assert_eq(bomm_ngram_source(3), BOMM_NGRAM_SOURCE_STRIDED);
+
+    // Rolling both indices over a message addresses the same values
+    bomm_message_t* message = bomm_message_init(
+        "vonvonjlooksjhffttteinseinsdreizwoyyqnnsneuninhaltxx");
+    unsigned int map_index = 0;
+    unsigned int strided_index = 0;
+    for (unsigned int i = 0; i < message->length; i++) {
+        unsigned int letter = message->letters[i];
+        map_index = bomm_ngram_roll(3, BOMM_NGRAM_SOURCE_MAP, map_index, letter);
+        strided_index = bomm_ngram_roll(3, BOMM_NGRAM_SOURCE_STRIDED, strided_index, letter);
+        cr_assert_eq(strided[strided_index], trigram_map->map[map_index]);
+    }
+
+    // Padding entries hold the fallback value
+    cr_assert_eq(strided[31], trigram_map->fallback);
+
+    // Scores match those of the map itself
+    double score = bomm_measure_message_sinkov(3, message);
+    free(bomm_ngram_strided[3]);
+    bomm_ngram_strided[3] = NULL;
+    cr_assert_eq(bomm_ngram_source(3), BOMM_NGRAM_SOURCE_MAP);
+    cr_assert_eq(bomm_measure_message_sinkov(3, message), score);
+
+    free(message);
+    bomm_measure_config_destroy();
+}
+
+Test(measure, bomm_measure_scrambler_sinkov_batch) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_measure_ngram_map_init(3, "./data/frequencies/enigma1941-trigram.txt");
+    bomm_message_t* message = bomm_message_init(
+        "nczwvusxpnyminhzxmqxsfwxwlkjahshnmcoccakuqpmkcsmhkseinjusblkiosxckub");
+
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(message->length));
+    scrambler->length = message->length;
+    bomm_enigma_generate_scrambler(scrambler, &key);
+
+    // More candidates than fit a single batch
+    unsigned int num_candidates = BOMM_MEASURE_MAX_BATCH_SIZE + 3;
+    bomm_plugboard_t candidates[num_candidates];
+    bomm_plugboard_t* plugboards[num_candidates];
+    for (unsigned int c = 0; c < num_candidates; c++) {
+        bomm_plugboard_init_identity(&candidates[c]);
+        candidates[c].map[c] = c + 13;
+        candidates[c].map[c + 13] = c;
+        plugboards[c] = &candidates[c];
+    }
+
+    // Scores match the serial kernel exactly for any prefetch distance and
+    // with or without the strided layout
+    double scores[num_candidates];
+    for (unsigned int strided = 0; strided < 2; strided++) {
+        if (strided == 1) {
+            free(bomm_ngram_strided[3]);
+            bomm_ngram_strided[3] = NULL;
+        }
+        for (unsigned int distance = 0; distance <= 64; distance += 16) {
+            bomm_measure_scrambler_sinkov_batch(
+                3, scrambler, plugboards, num_candidates, message, distance, scores);
+            for (unsigned int c = 0; c < num_candidates; c++) {
+                cr_assert_eq(
+                    scores[c],
+                    bomm_measure_scrambler_sinkov(3, scrambler, plugboards[c], message)
+                );
+            }
+        }
+    }
+
+    // Messages shorter than n have no windows to score
+    message->length = 2;
+    for (unsigned int c = 0; c < num_candidates; c++) {
+        scores[c] = -1;
+    }
+    bomm_measure_scrambler_sinkov_batch(
+        3, scrambler, plugboards, num_candidates, message, 16, scores);
+    for (unsigned int c = 0; c < num_candidates; c++) {
+        cr_assert_eq(scores[c], 0);
+    }
+
+    free(scrambler);
+    free(message);
+    bomm_measure_config_destroy();
+}
+
+Test(measure, bomm_simd) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_measure_ngram_map_init(2, "./data/frequencies/enigma1941-bigram.txt");
+    bomm_measure_ngram_map_init(3, "./data/frequencies/enigma1941-trigram.txt");
+
+    // Ciphertext of odd length leaving tails to the scalar fallback
+    bomm_message_t* ciphertext = bomm_message_init(
+        "nczwvusxpnyminhzxmqxsfwxwlkjahshnmcoccakuqpmkcsmhkseinjusblkiosxckub"
+        "hmllxcsjusrrdvkohulxwccbgvliyxeoahxrhkkfvdrewezlxobafgyjqsweqtedjai"
+        "yvqjutqxkyxavxhitlutsunqrtliabftqrnuwlqvnitrsctnqipklmaheefdcabcuwo"
+    );
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(ciphertext->length));
+    scrambler->length = ciphertext->length;
+
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    key.positions[3] = 7;
+    bomm_enigma_generate_scrambler(scrambler, &key);
+    bomm_swap_letter(&key.plugboard.map[0], &key.plugboard.map[4]);
+    bomm_swap_letter(&key.plugboard.map[13], &key.plugboard.map[25]);
+    bomm_swap_letter(&key.plugboard.map[2], &key.plugboard.map[17]);
+
+    bomm_message_t* plaintext = malloc(bomm_message_size_for_length(ciphertext->length));
+    bomm_scrambler_encrypt(scrambler, &key.plugboard, ciphertext, plaintext);
+
+    // Trie measure scoring common bigrams on top of the IC
+    bomm_trie_t* trie = bomm_trie_init(NULL);
+    const char* words[] = { "en", "er", "ei", "ch" };
+    for (unsigned int i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        bomm_message_t* word = bomm_message_init(words[i]);
+        bomm_trie_insert(trie, word, 0, 0.25);
+        free(word);
+    }
+    bomm_measure_trie_config = malloc(sizeof(bomm_measure_trie_config_t));
+    bomm_measure_trie_config->trie = trie;
+    bomm_measure_trie_config->automaton = bomm_trie_automaton_init(trie);
+    bomm_measure_trie_config->base_measure = BOMM_MEASURE_IC;
+    bomm_measure_trie_config->base_measure_scrambler =
+        bomm_measure_scrambler_function(BOMM_MEASURE_IC);
+
+    bomm_measure_t measures[] = {
+        BOMM_MEASURE_SINKOV_BIGRAM,
+        BOMM_MEASURE_SINKOV_TRIGRAM,
+        BOMM_MEASURE_IC,
+        BOMM_MEASURE_IC_BIGRAM,
+        BOMM_MEASURE_ENTROPY,
+        BOMM_MEASURE_ENTROPY_BIGRAM,
+        BOMM_MEASURE_TRIE
+    };
+
+    // Vectorized kernels are expected to agree with the scalar implementation
+    // for every instruction set extension supported by the CPU, with and
+    // without the strided and quantized layouts
+    bomm_simd_t max_simd = bomm_simd_detect();
+    for (unsigned int layout = 0; layout < 3; layout++) {
+        if (layout == 1) {
+            free(bomm_ngram_strided[2]);
+            free(bomm_ngram_strided[3]);
+            bomm_ngram_strided[2] = NULL;
+            bomm_ngram_strided[3] = NULL;
+        } else if (layout == 2) {
+            bomm_measure_ngram_qmap_init(3, BOMM_NGRAM_QUANTIZATION_INT16);
+        }
+
+        for (bomm_simd_t simd = BOMM_SIMD_NONE; simd <= max_simd; simd++) {
+            // Lengths exercising every tail
+            for (unsigned int length = 3; length <= ciphertext->length; length += 13) {
+                unsigned int original_length = ciphertext->length;
+                ciphertext->length = length;
+
+                bomm_letter_t letters[length];
+                bomm_simd_plaintext(simd, scrambler, &key.plugboard, ciphertext, letters);
+                cr_assert_arr_eq(letters, plaintext->letters, length);
+
+                unsigned int frequencies[BOMM_ALPHABET_SIZE * BOMM_ALPHABET_SIZE];
+                unsigned int expected_frequencies[BOMM_ALPHABET_SIZE * BOMM_ALPHABET_SIZE];
+                for (unsigned int n = 1; n <= 2; n++) {
+                    bomm_simd_frequency(simd, n, frequencies, letters, length);
+                    bomm_measure_scrambler_frequency(
+                        n, expected_frequencies, scrambler, &key.plugboard, ciphertext);
+                    cr_assert_arr_eq(
+                        frequencies,
+                        expected_frequencies,
+                        bomm_pow_map[n] * sizeof(unsigned int)
+                    );
+                }
+
+                for (unsigned int i = 0; i < sizeof(measures) / sizeof(measures[0]); i++) {
+                    bomm_measure_scrambler_function_t function =
+                        bomm_simd_measure_scrambler_function(measures[i], simd);
+                    cr_assert_neq(function, NULL);
+                    double score = function(scrambler, &key.plugboard, ciphertext);
+                    double expected_score = bomm_measure_scrambler(
+                        measures[i], scrambler, &key.plugboard, ciphertext);
+                    bool quantized =
+                        layout == 2 && measures[i] == BOMM_MEASURE_SINKOV_TRIGRAM;
+                    if (quantized || measures[i] >= BOMM_MEASURE_IC) {
+                        cr_assert_eq(score, expected_score);
+                    } else {
+                        cr_assert_float_eq(score, expected_score, 0.000000001);
+                    }
+                }
+
+                ciphertext->length = original_length;
+            }
+        }
+    }
+
+    free(plaintext);
+    free(scrambler);
+    free(ciphertext);
+    bomm_measure_config_destroy();
 }
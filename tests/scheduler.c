@@ -0,0 +1,73 @@
+//
+//  scheduler.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <criterion/criterion.h>
+#include <pthread.h>
+#include "../src/scheduler.h"
+
+Test(scheduler, bomm_scheduler_claim) {
+    bomm_scheduler_t scheduler;
+    cr_assert_eq(bomm_scheduler_init(&scheduler, 10000, 4, 26), &scheduler);
+
+    // Chunks are handed out in order and shrink towards the end
+    unsigned long start, count;
+    unsigned long next_start = 0;
+    unsigned long last_count = 10000;
+    while (bomm_scheduler_claim(&scheduler, &start, &count)) {
+        cr_assert_eq(start, next_start);
+        cr_assert_leq(count, last_count);
+        cr_assert(count >= 26 || start + count == 10000);
+        next_start = start + count;
+        last_count = count;
+    }
+    cr_assert_eq(next_start, 10000);
+
+    // The first chunk takes a share of the keys per worker
+    bomm_scheduler_init(&scheduler, 10000, 4, 26);
+    cr_assert(bomm_scheduler_claim(&scheduler, &start, &count));
+    cr_assert_eq(start, 0);
+    cr_assert_eq(count, 10000 / (4 * BOMM_SCHEDULER_CHUNKS_PER_WORKER));
+
+    // Fewer keys than the minimum chunk size are handed out at once
+    bomm_scheduler_init(&scheduler, 10, 4, 26);
+    cr_assert(bomm_scheduler_claim(&scheduler, &start, &count));
+    cr_assert_eq(start, 0);
+    cr_assert_eq(count, 10);
+    cr_assert_not(bomm_scheduler_claim(&scheduler, &start, &count));
+}
+
+/**
+ * Claim chunks until the scheduler is exhausted, counting the claimed keys.
+ */
+static void* _bomm_test_scheduler_worker(void* arg) {
+    bomm_scheduler_t* scheduler = arg;
+    unsigned long start, count;
+    unsigned long num_claimed = 0;
+    while (bomm_scheduler_claim(scheduler, &start, &count)) {
+        num_claimed += count;
+    }
+    return (void*) num_claimed;
+}
+
+Test(scheduler, bomm_scheduler_claim_concurrently) {
+    unsigned long num_keys = 1000003;
+    bomm_scheduler_t scheduler;
+    bomm_scheduler_init(&scheduler, num_keys, 8, 1);
+
+    // Every key is claimed exactly once
+    pthread_t threads[8];
+    for (unsigned int i = 0; i < 8; i++) {
+        pthread_create(&threads[i], NULL, _bomm_test_scheduler_worker, &scheduler);
+    }
+    unsigned long num_claimed = 0;
+    for (unsigned int i = 0; i < 8; i++) {
+        void* result;
+        pthread_join(threads[i], &result);
+        num_claimed += (unsigned long) result;
+    }
+    cr_assert_eq(num_claimed, num_keys);
+}
@@ -0,0 +1,209 @@
+//
+//  scrambler.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <criterion/criterion.h>
+#include "shared/helpers.h"
+#include "../src/scrambler.h"
+
+Test(scrambler, bomm_scrambler_engine_load) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    key_space.wheel_sets[1][2].name[0] = '\0';
+    key_space.wheel_sets[2][3].name[0] = '\0';
+    key_space.wheel_sets[3][4].name[0] = '\0';
+    key_space.ring_masks[3] = 0x1001;
+    key_space.position_masks[1] = 0x2000003;
+    key_space.position_masks[2] = 0x318318;
+
+    unsigned int length = 60;
+    bomm_scrambler_t* expected_scrambler = malloc(bomm_scrambler_size(length));
+    expected_scrambler->length = length;
+    bomm_scrambler_t* actual_scrambler = malloc(bomm_scrambler_size(length));
+    actual_scrambler->length = length;
+    bomm_scrambler_engine_t* engine =
+        bomm_scrambler_engine_init(NULL, &key_space, length);
+    cr_assert_neq(engine, NULL);
+
+    bomm_key_iterator_t key_iterator;
+    cr_assert_eq(bomm_key_iterator_init(&key_iterator, &key_space), &key_iterator);
+
+    // Every scrambler served by the engine is expected to match the scrambler
+    // generated from scratch
+    unsigned long num_keys = 0;
+    do {
+        bomm_key_t original_key;
+        memcpy(&original_key, &key_iterator.key, sizeof(original_key));
+        bomm_enigma_generate_scrambler(expected_scrambler, &key_iterator.key);
+        bomm_scrambler_engine_load(engine, &key_iterator.key, actual_scrambler);
+        cr_assert_arr_eq(&key_iterator.key, &original_key, sizeof(original_key));
+        cr_assert_arr_eq(
+            actual_scrambler->map,
+            expected_scrambler->map,
+            length * BOMM_ALPHABET_SIZE,
+            "Scrambler mismatch for key at index %lu",
+            num_keys
+        );
+        num_keys++;
+    } while (!bomm_key_iterator_next(&key_iterator));
+
+    cr_assert_eq(engine->num_scramblers, num_keys);
+
+    // Expecting the tape to be reused for most keys
+    cr_assert_lt(engine->num_tapes * 4, num_keys);
+
+    free(engine);
+    free(actual_scrambler);
+    free(expected_scrambler);
+}
+
+Test(scrambler, bomm_scrambler_engine_load_double_stepping) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+
+    unsigned int length = 5;
+    bomm_scrambler_t* expected_scrambler = malloc(bomm_scrambler_size(length));
+    expected_scrambler->length = length;
+    bomm_scrambler_t* actual_scrambler = malloc(bomm_scrambler_size(length));
+    actual_scrambler->length = length;
+    bomm_scrambler_engine_t* engine =
+        bomm_scrambler_engine_init(NULL, &key_space, length);
+
+    // Wheel order I, II, III with the middle wheel right before its turnover
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    unsigned int wheel_indices[] = {0, 0, 1, 2, 0};
+    for (unsigned int slot = 0; slot < 5; slot++) {
+        memcpy(&key.wheels[slot], &key_space.wheel_sets[slot][wheel_indices[slot]], sizeof(bomm_wheel_t));
+    }
+    key.positions[1] = 0;
+    key.positions[2] = 3;
+
+    for (unsigned int position = 0; position < BOMM_ALPHABET_SIZE; position++) {
+        key.positions[3] = position;
+        bomm_enigma_generate_scrambler(expected_scrambler, &key);
+        bomm_scrambler_engine_load(engine, &key, actual_scrambler);
+        cr_assert_arr_eq(
+            actual_scrambler->map,
+            expected_scrambler->map,
+            length * BOMM_ALPHABET_SIZE
+        );
+    }
+
+    // The tape needs to be regenerated after the turnover of wheel III (v)
+    cr_assert_eq(engine->num_tapes, 2);
+
+    // Moving the middle wheel to its turnover position causes the next step
+    // to double step, thus every window needs its own tape
+    key.positions[2] = 4;
+    for (unsigned int position = 0; position < 4; position++) {
+        key.positions[3] = position;
+        bomm_enigma_generate_scrambler(expected_scrambler, &key);
+        bomm_scrambler_engine_load(engine, &key, actual_scrambler);
+        cr_assert_arr_eq(
+            actual_scrambler->map,
+            expected_scrambler->map,
+            length * BOMM_ALPHABET_SIZE
+        );
+    }
+    cr_assert_eq(engine->num_tapes, 6);
+
+    free(engine);
+    free(actual_scrambler);
+    free(expected_scrambler);
+}
+
+Test(scrambler, bomm_scrambler_engine_load_composite) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+
+    unsigned int length = 30;
+    bomm_scrambler_t* expected_scrambler = malloc(bomm_scrambler_size(length));
+    expected_scrambler->length = length;
+    bomm_scrambler_t* actual_scrambler = malloc(bomm_scrambler_size(length));
+    actual_scrambler->length = length;
+    bomm_scrambler_engine_t* engine =
+        bomm_scrambler_engine_init(NULL, NULL, length);
+
+    // Enigma M4 with thin reflector and Greek wheel left of the left wheel
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    const char* wheel_names[] =
+        {"UKW-B-thin", "beta", "I", "II", "III", "ETW-ABC"};
+    key.num_slots = 6;
+    key.fast_wheel_slot = 4;
+    for (unsigned int slot = 0; slot < 6; slot++) {
+        bomm_wheel_init_with_name(&key.wheels[slot], wheel_names[slot]);
+        key.rotating_slots[slot] = slot >= 2 && slot <= 4;
+        key.rings[slot] = 0;
+        key.positions[slot] = 0;
+    }
+    key.rings[1] = 7;
+    key.rings[4] = 3;
+    key.positions[1] = 11;
+
+    for (unsigned int position = 0; position < BOMM_ALPHABET_SIZE; position += 5) {
+        key.positions[3] = position;
+        for (unsigned int fast = 0; fast < BOMM_ALPHABET_SIZE; fast++) {
+            key.positions[4] = fast;
+            bomm_enigma_generate_scrambler(expected_scrambler, &key);
+            bomm_scrambler_engine_load(engine, &key, actual_scrambler);
+            cr_assert_arr_eq(
+                actual_scrambler->map,
+                expected_scrambler->map,
+                length * BOMM_ALPHABET_SIZE
+            );
+        }
+    }
+
+    // The composite reflector only changes when the middle wheel steps
+    unsigned long num_composites = engine->num_composites;
+    cr_assert_leq(num_composites, BOMM_ALPHABET_SIZE * 4);
+
+    // Revisiting the same settings is served from the cache entirely
+    key.positions[3] = 0;
+    key.positions[4] = 0;
+    bomm_enigma_generate_scrambler(expected_scrambler, &key);
+    bomm_scrambler_engine_load(engine, &key, actual_scrambler);
+    cr_assert_arr_eq(
+        actual_scrambler->map,
+        expected_scrambler->map,
+        length * BOMM_ALPHABET_SIZE
+    );
+    cr_assert_eq(engine->num_composites, num_composites);
+
+    // Changing the Greek wheel invalidates the cache
+    bomm_wheel_init_with_name(&key.wheels[1], "gamma");
+    bomm_enigma_generate_scrambler(expected_scrambler, &key);
+    bomm_scrambler_engine_load(engine, &key, actual_scrambler);
+    cr_assert_arr_eq(
+        actual_scrambler->map,
+        expected_scrambler->map,
+        length * BOMM_ALPHABET_SIZE
+    );
+    cr_assert_gt(engine->num_composites, num_composites);
+
+    // Fixed slots get folded again when their settings change
+    for (unsigned int ring = 0; ring < BOMM_ALPHABET_SIZE; ring += 9) {
+        key.rings[1] = ring;
+        key.rings[5] = ring;
+        key.positions[0] = ring % 2;
+        bomm_enigma_generate_scrambler(expected_scrambler, &key);
+        bomm_scrambler_engine_load(engine, &key, actual_scrambler);
+        cr_assert_arr_eq(
+            actual_scrambler->map,
+            expected_scrambler->map,
+            length * BOMM_ALPHABET_SIZE
+        );
+    }
+
+    free(engine);
+    free(actual_scrambler);
+    free(expected_scrambler);
+}
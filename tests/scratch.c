@@ -0,0 +1,103 @@
+//
+//  scratch.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <criterion/criterion.h>
+#include "shared/helpers.h"
+#include "../src/pass.h"
+#include "../src/scrambler.h"
+#include "../src/scratch.h"
+
+Test(scratch, bomm_scratch_init) {
+    unsigned int length = 50;
+    bomm_scratch_t* scratch = bomm_scratch_init(NULL, length);
+    cr_assert_neq(scratch, NULL);
+    cr_assert_eq(scratch->num_allocs, 0);
+
+    // Buffers up to the length are served from the scratch
+    bomm_delta_t* delta = bomm_scratch_delta(scratch, length);
+    bomm_message_t* plaintext = bomm_scratch_plaintext(scratch, length - 1);
+    cr_assert_eq(delta, scratch->delta);
+    cr_assert_eq(plaintext, scratch->plaintext);
+    cr_assert_leq(
+        (char*) delta + bomm_delta_size(length),
+        (char*) plaintext
+    );
+    cr_assert_leq(
+        (char*) plaintext + bomm_message_size_for_length(length),
+        (char*) scratch + bomm_scratch_size(length)
+    );
+    bomm_scratch_release(scratch, delta);
+    bomm_scratch_release(scratch, plaintext);
+    cr_assert_eq(scratch->num_allocs, 0);
+
+    // Longer buffers are allocated on the heap and counted
+    delta = bomm_scratch_delta(scratch, length + 1);
+    cr_assert_neq(delta, NULL);
+    cr_assert_neq(delta, scratch->delta);
+    bomm_scratch_release(scratch, delta);
+    plaintext = bomm_scratch_plaintext(scratch, length + 1);
+    cr_assert_neq(plaintext, scratch->plaintext);
+    bomm_scratch_release(scratch, plaintext);
+    cr_assert_eq(scratch->num_allocs, 2);
+
+    free(scratch);
+}
+
+Test(scratch, bomm_pass_run) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_message_t* ciphertext = bomm_message_init(
+        "ykzqsnwovuhwyhqkzrbbwlunlrpgdtopkjvfubqlhhmsazrpqpjqmbldhamvkxwd" \
+        "yssqztrvyaytfnuihjnbfmhfowfmyzpnnsyyxgvhsjoxzcnctvctyzv"
+    );
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    bomm_key_t key;
+    bomm_key_init(&key, &key_space);
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(ciphertext->length));
+    scrambler->length = ciphertext->length;
+    bomm_enigma_generate_scrambler(scrambler, &key);
+
+    bomm_pass_t pass;
+    pass.type = BOMM_PASS_HILL_CLIMB;
+    pass.config.hill_climb.measure = BOMM_MEASURE_IC;
+    pass.config.hill_climb.final_measure = BOMM_MEASURE_IC_BIGRAM;
+    pass.config.hill_climb.final_measure_min_num_plugs = 5;
+    pass.config.hill_climb.backtracking_min_num_plugs = 5;
+    pass.config.hill_climb.measure_scrambler =
+        bomm_measure_scrambler_function(BOMM_MEASURE_IC);
+    pass.config.hill_climb.measure_scrambler_bounded =
+        bomm_measure_scrambler_bounded_function(BOMM_MEASURE_IC);
+    pass.config.hill_climb.final_measure_scrambler =
+        bomm_measure_scrambler_function(BOMM_MEASURE_IC_BIGRAM);
+    pass.config.hill_climb.final_measure_scrambler_bounded =
+        bomm_measure_scrambler_bounded_function(BOMM_MEASURE_IC_BIGRAM);
+
+    unsigned int num_decrypts = 0;
+    unsigned int num_aborts = 0;
+    bomm_plugboard_t expected_plugboard;
+    bomm_plugboard_init_identity(&expected_plugboard);
+    double expected_score = bomm_pass_run(
+        &pass, &expected_plugboard, scrambler, ciphertext, 0, NULL,
+        &num_decrypts, &num_aborts);
+
+    // Passes run on the scratch repeatedly without touching the heap
+    bomm_scratch_t* scratch = bomm_scratch_init(NULL, ciphertext->length);
+    for (unsigned int i = 0; i < 3; i++) {
+        bomm_plugboard_t plugboard;
+        bomm_plugboard_init_identity(&plugboard);
+        double score = bomm_pass_run(
+            &pass, &plugboard, scrambler, ciphertext, 0, scratch,
+            &num_decrypts, &num_aborts);
+        cr_assert_eq(score, expected_score);
+        cr_assert_arr_eq(plugboard.map, expected_plugboard.map, sizeof(plugboard.map));
+    }
+    cr_assert_eq(scratch->num_allocs, 0);
+
+    free(scratch);
+    free(scrambler);
+    free(ciphertext);
+}
@@ -0,0 +1,105 @@
+//
+//  simd.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <criterion/criterion.h>
+#include "shared/helpers.h"
+#include "../src/scrambler.h"
+#include "../src/simd.h"
+
+Test(simd, bomm_simd_from_string) {
+    cr_assert_eq(bomm_simd_from_string("scalar"), BOMM_SIMD_NONE);
+    cr_assert_eq(bomm_simd_from_string("avx2"), BOMM_SIMD_AVX2);
+    cr_assert_eq(bomm_simd_from_string("avx512"), BOMM_SIMD_AVX512);
+    cr_assert_eq(bomm_simd_from_string("neon"), BOMM_SIMD_UNKNOWN);
+    cr_assert_str_eq(bomm_simd_to_string(BOMM_SIMD_AVX2), "avx2");
+}
+
+Test(simd, bomm_simd_select) {
+    bomm_simd_t max_simd = bomm_simd_detect();
+    cr_assert_eq(bomm_simd_selected(), max_simd);
+
+    // The scalar fallback is always supported
+    cr_assert(bomm_simd_select(BOMM_SIMD_NONE));
+    cr_assert_eq(bomm_simd_selected(), BOMM_SIMD_NONE);
+
+    if (max_simd < BOMM_SIMD_AVX512) {
+        cr_assert_not(bomm_simd_select(BOMM_SIMD_AVX512));
+        cr_assert_eq(bomm_simd_selected(), BOMM_SIMD_NONE);
+    }
+
+    cr_assert(bomm_simd_select(max_simd));
+    cr_assert_eq(bomm_simd_selected(), max_simd);
+}
+
+Test(simd, bomm_simd_compose) {
+    bomm_test_skip_if_non_latin_alphabet;
+
+    // Maps are followed by readable bytes as required
+    bomm_letter_t maps[4][32];
+    for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+        maps[0][letter] = (letter * 7 + 3) % BOMM_ALPHABET_SIZE;
+        maps[1][letter] = (letter * 5 + 11) % BOMM_ALPHABET_SIZE;
+        maps[2][letter] = BOMM_ALPHABET_SIZE - 1 - letter;
+    }
+
+    for (bomm_simd_t simd = BOMM_SIMD_NONE; simd <= bomm_simd_detect(); simd++) {
+        memset(maps[3], 0xff, sizeof(maps[3]));
+        bomm_simd_compose(simd, maps[3], maps[0], maps[1], maps[2]);
+        for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+            cr_assert_eq(maps[3][letter], maps[2][maps[1][maps[0][letter]]]);
+        }
+
+        // Letters past the alphabet are left untouched
+        cr_assert_eq(maps[3][BOMM_ALPHABET_SIZE], 0xff);
+    }
+}
+
+Test(simd, bomm_scrambler_engine_load) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_key_space_t key_space;
+    bomm_key_space_init_enigma_i(&key_space);
+    key_space.position_masks[1] = 0x3;
+    key_space.position_masks[2] = 0x318318;
+
+    unsigned int length = 40;
+    bomm_scrambler_t* expected_scrambler = malloc(bomm_scrambler_size(length));
+    expected_scrambler->length = length;
+    bomm_scrambler_t* actual_scrambler = malloc(bomm_scrambler_size(length));
+    actual_scrambler->length = length;
+
+    // Scramblers generated by every kernel variant are expected to match
+    bomm_simd_t max_simd = bomm_simd_detect();
+    for (bomm_simd_t simd = BOMM_SIMD_NONE; simd <= max_simd; simd++) {
+        cr_assert(bomm_simd_select(simd));
+        bomm_scrambler_engine_t* engine =
+            bomm_scrambler_engine_init(NULL, &key_space, length);
+        cr_assert_neq(engine, NULL);
+
+        bomm_key_iterator_t key_iterator;
+        bomm_key_iterator_init(&key_iterator, &key_space);
+        for (unsigned int i = 0; i < 2000; i++) {
+            bomm_enigma_generate_scrambler(expected_scrambler, &key_iterator.key);
+            bomm_scrambler_engine_load(engine, &key_iterator.key, actual_scrambler);
+            cr_assert_arr_eq(
+                actual_scrambler->map,
+                expected_scrambler->map,
+                length * BOMM_ALPHABET_SIZE,
+                "Scrambler mismatch for kernel variant %s",
+                bomm_simd_to_string(simd)
+            );
+            if (bomm_key_iterator_next(&key_iterator)) {
+                break;
+            }
+        }
+
+        free(engine);
+    }
+    bomm_simd_select(max_simd);
+
+    free(actual_scrambler);
+    free(expected_scrambler);
+}
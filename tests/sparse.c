@@ -0,0 +1,58 @@
+//
+//  sparse.c
+//  Bomm
+//
+//  Created by agent on 17/10/2026.
+//
+
+#include <criterion/criterion.h>
+#include "../src/sparse.h"
+
+Test(sparse, bomm_sparse_lookup) {
+    // Spread keys over the 26^6 key space like hexagram indices
+    unsigned int num_entries = 100000;
+    uint32_t* keys = malloc(num_entries * sizeof(uint32_t));
+    float* values = malloc(num_entries * sizeof(float));
+    for (unsigned int i = 0; i < num_entries; i++) {
+        keys[i] = (uint32_t) ((i * 2654435761ULL) % 308915776);
+        values[i] = -(float) i;
+    }
+
+    bomm_sparse_t* sparse = bomm_sparse_init(keys, values, num_entries, 1.5f);
+    cr_assert_neq(sparse, NULL);
+    cr_assert_eq(sparse->num_entries, num_entries);
+    cr_assert_lt(bomm_sparse_size(sparse), num_entries * 16);
+
+    // Every key stored is found
+    for (unsigned int i = 0; i < num_entries; i++) {
+        cr_assert_eq(bomm_sparse_lookup(sparse, keys[i]), values[i]);
+    }
+
+    // Keys not stored return the fallback value
+    for (uint32_t key = 1; key < 100000; key += 7) {
+        bool stored = false;
+        for (unsigned int i = 0; !stored && i < num_entries; i++) {
+            stored = keys[i] == key;
+        }
+        if (!stored) {
+            cr_assert_eq(bomm_sparse_lookup(sparse, key), 1.5f);
+        }
+    }
+    free(sparse);
+
+    // Keys given more than once take the value given last
+    keys[1] = keys[0];
+    sparse = bomm_sparse_init(keys, values, 2, 1.5f);
+    cr_assert_eq(sparse->num_entries, 1);
+    cr_assert_eq(bomm_sparse_lookup(sparse, keys[0]), values[1]);
+    free(sparse);
+
+    // Empty maps only return the fallback value
+    sparse = bomm_sparse_init(keys, values, 0, 1.5f);
+    cr_assert_neq(sparse, NULL);
+    cr_assert_eq(bomm_sparse_lookup(sparse, keys[0]), 1.5f);
+    free(sparse);
+
+    free(keys);
+    free(values);
+}
@@ -119,3 +119,78 @@ Test(trie, bomm_trie_measure_message) {
     bomm_trie_destroy(trie);
     free(trie);
 }
+
+Test(trie, bomm_trie_automaton) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_message_t* message;
+    bomm_trie_t* trie = bomm_trie_init(NULL);
+
+    message = bomm_message_init("foo");
+    bomm_trie_insert(trie, message, 0, 1.0);
+    free(message);
+    message = bomm_message_init("bar");
+    bomm_trie_insert(trie, message, 0, 100.0);
+    free(message);
+    message = bomm_message_init("foobar");
+    bomm_trie_insert(trie, message, 0, 10000.0);
+    free(message);
+    message = bomm_message_init("oba");
+    bomm_trie_insert(trie, message, 0, 0.5);
+    free(message);
+
+    bomm_trie_automaton_t* automaton = bomm_trie_automaton_init(trie);
+    cr_assert_neq(automaton, NULL);
+
+    // Reaching the end of foobar also completes bar (and oba before)
+    cr_assert_eq(automaton->max_output, 10100.0);
+
+    // Automaton scores match walking the trie from each start position
+    const char* strings[] = {
+        "foobarbarfoobarfoofoobarbar",
+        "ffoofoobfoobarbaoobarrfoob",
+        "helloworld",
+        "",
+    };
+    for (unsigned int i = 0; i < sizeof(strings) / sizeof(strings[0]); i++) {
+        message = bomm_message_init(strings[i]);
+        cr_assert_eq(
+            bomm_trie_automaton_measure_message(automaton, message),
+            bomm_trie_measure_message(trie, message)
+        );
+        free(message);
+    }
+
+    // Score the message put through an identity scrambler and plugboard
+    message = bomm_message_init("foobarbarfoobarfoofoobarbar");
+    double score = bomm_trie_measure_message(trie, message);
+    bomm_scrambler_t* scrambler = malloc(bomm_scrambler_size(message->length));
+    scrambler->length = message->length;
+    for (unsigned int index = 0; index < message->length; index++) {
+        for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+            scrambler->map[index][letter] = letter;
+        }
+    }
+    bomm_plugboard_t plugboard;
+    bomm_plugboard_init_identity(&plugboard);
+    cr_assert_eq(
+        bomm_trie_automaton_measure_scrambler(
+            automaton, scrambler, &plugboard, message),
+        score
+    );
+    cr_assert_eq(
+        bomm_trie_automaton_measure_scrambler_bounded(
+            automaton, scrambler, &plugboard, message, score - 1.0),
+        score
+    );
+    cr_assert_eq(
+        bomm_trie_automaton_measure_scrambler_bounded(
+            automaton, scrambler, &plugboard, message, score),
+        -INFINITY
+    );
+    free(scrambler);
+    free(message);
+
+    free(automaton);
+    bomm_trie_destroy(trie);
+    free(trie);
+}
@@ -20,6 +20,23 @@ Test(utility, bomm_str_unique) {
     cr_assert_eq(bomm_str_unique("01234567890"), false);
 }
 
+Test(utility, bomm_fingerprint) {
+    unsigned char data[] = "abcdefghijklmnopqrstuvwxyz";
+    unsigned long long fingerprint =
+        bomm_fingerprint(data, sizeof(data), 0);
+    cr_assert_neq(fingerprint, 0);
+    cr_assert_eq(bomm_fingerprint(data, sizeof(data), 0), fingerprint);
+
+    // Any change in data, size, or seed is expected to change the fingerprint
+    cr_assert_neq(bomm_fingerprint(data, sizeof(data), 1), fingerprint);
+    cr_assert_neq(bomm_fingerprint(data, sizeof(data) - 1, 0), fingerprint);
+    data[0] = 'b';
+    cr_assert_neq(bomm_fingerprint(data, sizeof(data), 0), fingerprint);
+    data[0] = 'a';
+    data[25] = 'y';
+    cr_assert_neq(bomm_fingerprint(data, sizeof(data), 0), fingerprint);
+}
+
 Test(utility, bomm_hardware_concurrency) {
     unsigned int num_threads = bomm_hardware_concurrency();
     cr_assert_geq(num_threads, 1);
@@ -97,3 +97,33 @@ Test(wiring, bomm_wheel_set_init_with_json) {
     cr_assert_arr_eq(&wheel_set[1], &wheels[0], sizeof(bomm_wheel_t));
     cr_assert_arr_eq(&wheel_set[2], &wheels[2], sizeof(bomm_wheel_t));
 }
+
+Test(wiring, bomm_wheel_offset_maps_init) {
+    bomm_test_skip_if_non_latin_alphabet;
+    bomm_wheel_t wheel;
+    cr_assert_eq(bomm_wheel_init_with_name(&wheel, "I"), &wheel);
+    bomm_wheel_offset_maps_t offset_maps;
+    bomm_wheel_offset_maps_init(&offset_maps, &wheel);
+
+    // Offset 0 is expected to match the wiring itself
+    cr_assert_arr_eq(offset_maps.map[0], wheel.wiring.map, BOMM_ALPHABET_SIZE);
+    cr_assert_arr_eq(offset_maps.rev[0], wheel.wiring.rev, BOMM_ALPHABET_SIZE);
+
+    // Position b, ring a: Letter a enters contact b (k) and leaves as j
+    cr_assert_eq(bomm_wheel_offset(1, 0), 1);
+    cr_assert_eq(offset_maps.map[1][0], 9);
+
+    // Position a, ring b: Letter a enters contact z (j) and leaves as k
+    cr_assert_eq(bomm_wheel_offset(0, 1), 25);
+    cr_assert_eq(offset_maps.map[25][0], 10);
+
+    // Forward and reverse maps are expected to be inverse to each other
+    for (unsigned int offset = 0; offset < BOMM_ALPHABET_SIZE; offset++) {
+        for (unsigned int letter = 0; letter < BOMM_ALPHABET_SIZE; letter++) {
+            cr_assert_eq(
+                offset_maps.rev[offset][offset_maps.map[offset][letter]],
+                letter
+            );
+        }
+    }
+}
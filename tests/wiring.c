@@ -10,13 +10,13 @@
 #include "../src/wiring.h"
 #include "../src/utility.h"
 
-unsigned int bomm_test_latin_identity_plugboard_map[26] = {
+bomm_letter_t bomm_test_latin_identity_plugboard_map[26] = {
      0,  1,  2,  3,  4,  5,  6,  7,  8,  9,
     10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
     20, 21, 22, 23, 24, 25
 };
 
-unsigned int bomm_test_latin_example_plugboard_map[26] = {
+bomm_letter_t bomm_test_latin_example_plugboard_map[26] = {
      0,  2,  1, 23, 16, 11,  6, 24,  8,  9,
     10,  5, 14, 25, 12, 17,  4, 15, 19, 18,
     20, 22, 21,  3,  7, 13
@@ -85,7 +85,7 @@ Test(key, bomm_wiring_plugboard_validate) {
     for (unsigned int i = 0; i < BOMM_ALPHABET_SIZE; i++) {
         for (unsigned int k = i + 1; k < BOMM_ALPHABET_SIZE; k++) {
             bomm_plugboard_init_identity(&plugboard);
-            bomm_swap(&plugboard.map[i], &plugboard.map[k]);
+            bomm_swap_letter(&plugboard.map[i], &plugboard.map[k]);
             cr_assert_eq(bomm_plugboard_validate(&plugboard), true);
         }
     }
@@ -97,8 +97,8 @@ Test(key, bomm_wiring_plugboard_validate) {
 
     // Violating the involution rule is invalid
     bomm_plugboard_init_identity(&plugboard);
-    bomm_swap(&plugboard.map[0], &plugboard.map[1]);
-    bomm_swap(&plugboard.map[1], &plugboard.map[2]);
+    bomm_swap_letter(&plugboard.map[0], &plugboard.map[1]);
+    bomm_swap_letter(&plugboard.map[1], &plugboard.map[2]);
     cr_assert_eq(bomm_plugboard_validate(&plugboard), false);
 }
 
@@ -114,6 +114,7 @@ Test(key, bomm_wiring_plugboard_stringify) {
 
     // Example plugboard
     bomm_plugboard_t example;
+    bomm_plugboard_init_identity(&example);
     memcpy(
         example.map,
         bomm_test_latin_example_plugboard_map,